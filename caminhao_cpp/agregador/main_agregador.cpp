@@ -0,0 +1,119 @@
+/**
+ * @file main_agregador.cpp
+ * @brief Ponto de entrada do agregador de estado da frota.
+ *
+ * Assina a telemetria e o modo de todos os caminhões e publica um único
+ * feed para as interfaces: deltas em atr/frota/delta e quadros-chave
+ * retidos em atr/frota/estado.
+ *
+ * Uso:
+ *   agregador_frota [--hz HZ] [--chave S] [--tol-pos U] [--tol-ang G]
+ *                   [--tol-temp C] [--timeout S]
+ *                   [--broker HOST] [--porta P] [--transporte paho|local]
+ */
+
+#include "Agregador_Frota.h"
+#include "Cliente_MQTT.h"
+#include "Marcos_Inicializacao.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> g_parar{false};
+
+void ao_sinal(int) { g_parar.store(true); }
+
+void uso(const char* prog) {
+    std::cerr << "Uso: " << prog
+              << " [--hz HZ] [--chave S] [--tol-pos U] [--tol-ang G] [--tol-temp C] [--timeout S]"
+                 " [--broker HOST] [--porta P] [--transporte paho|local]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    atr::marcar_inicio_processo();
+
+    atr::ConfigAgregador cfg;
+    std::string host = "localhost";
+    int porta = 1883;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool tem_valor = (i + 1 < argc);
+        try {
+            if (arg == "--hz" && tem_valor)            cfg.hz = std::stod(argv[++i]);
+            else if (arg == "--chave" && tem_valor)    cfg.intervalo_chave_s = std::stod(argv[++i]);
+            else if (arg == "--tol-pos" && tem_valor)  cfg.tol_pos = std::stod(argv[++i]);
+            else if (arg == "--tol-ang" && tem_valor)  cfg.tol_ang = std::stod(argv[++i]);
+            else if (arg == "--tol-temp" && tem_valor) cfg.tol_temp = std::stod(argv[++i]);
+            else if (arg == "--timeout" && tem_valor)  cfg.timeout_s = std::stod(argv[++i]);
+            else if (arg == "--broker" && tem_valor)   host = argv[++i];
+            else if (arg == "--porta" && tem_valor)    porta = std::stoi(argv[++i]);
+            else if (arg == "--transporte" && tem_valor) {
+                atr::TransporteMQTT t;
+                if (!atr::transporte_de_texto(argv[++i], t)) {
+                    uso(argv[0]);
+                    return 1;
+                }
+                atr::definir_transporte_mqtt(t);
+            } else {
+                uso(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Agregador] valor inválido para " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, ao_sinal);
+    std::signal(SIGTERM, ao_sinal);
+
+    const std::string client_id =
+        "agregador_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    auto cliente = atr::criar_cliente_mqtt(atr::uri_broker(host, porta), client_id);
+
+    // conecta com retentativas (não falha se o broker ainda está subindo)
+    atr::AgregadorFrota agregador(*cliente, cfg);
+    agregador.iniciar();
+
+    // relatório a cada ~5 s: tráfego de entrada (tópicos brutos) x saída (feed)
+    std::thread relatorio([&agregador] {
+        using Clock = std::chrono::steady_clock;
+        auto t_ant = Clock::now();
+        std::uint64_t ent_ant = 0, sai_ant = 0, q_ant = 0;
+        while (!g_parar.load()) {
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            const auto t = Clock::now();
+            const double seg = std::chrono::duration<double>(t - t_ant).count();
+            const std::uint64_t ent = agregador.bytes_entrada();
+            const std::uint64_t sai = agregador.bytes_saida();
+            const std::uint64_t q = agregador.quadros();
+            std::cout << "[Agregador] " << agregador.caminhoes() << " caminhões, "
+                      << (q - q_ant) / seg << " quadros/s, entrada " << (ent - ent_ant) / seg / 1024.0
+                      << " KiB/s, saída " << (sai - sai_ant) / seg / 1024.0 << " KiB/s\n";
+            t_ant = t;
+            ent_ant = ent;
+            sai_ant = sai;
+            q_ant = q;
+        }
+    });
+
+    agregador.executar(g_parar);
+    g_parar.store(true);
+    relatorio.join();
+
+    try {
+        cliente->parar_consumo();
+        cliente->desconectar();
+    } catch (...) {
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file bench_buffer_circular.cpp
+ * @brief Custo do leitor do BufferCircular em função da capacidade.
+ *
+ * Mede, para capacidades de 100, 60 000 (60 s a 1 kHz) e 600 000:
+ * - instantaneo() + sobrescritos(): deve ser constante (O(1));
+ * - get_posicao_recente(): constante;
+ * - get_todas(): cópia do anel inteiro, cresce com a capacidade
+ *   (referência para comparação).
+ * Cada cenário roda com o escritor parado e com um escritor contínuo
+ * ("ativo", em outra thread: o caso do Tratamento de Sensores).
+ *
+ * Uso:
+ *   bench_buffer_circular [--iteracoes N]
+ */
+
+#include "Buffer_Circular.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// evita que o compilador descarte a leitura medida
+volatile std::uint64_t g_sumidouro = 0;
+
+template <typename F>
+double ns_por_chamada(std::size_t iteracoes, F&& f) {
+    const auto t0 = Clock::now();
+    std::uint64_t acc = 0;
+    for (std::size_t k = 0; k < iteracoes; ++k) acc += f();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    g_sumidouro = g_sumidouro + acc;
+    return ns / static_cast<double>(iteracoes);
+}
+
+void medir(std::size_t capacidade, std::size_t iteracoes, bool com_escritor) {
+    BufferCircular buffer(capacidade);
+    BufferCircular::PosicaoData p;
+    for (std::size_t i = 0; i < capacidade; ++i) {
+        p.i_pos_x = static_cast<double>(i);
+        buffer.set_posicao_tratada(p);
+    }
+
+    std::atomic<bool> parar{false};
+    std::thread escritor;
+    if (com_escritor) {
+        escritor = std::thread([&] {
+            BufferCircular::PosicaoData q;
+            while (!parar.load(std::memory_order_relaxed)) {
+                q.i_pos_x += 1.0;
+                buffer.set_posicao_tratada(q);
+            }
+        });
+    }
+
+    const double t_inst = ns_por_chamada(iteracoes, [&] {
+        const BufferCircular::Instantaneo inst = buffer.instantaneo();
+        return static_cast<std::uint64_t>(inst.tamanho() + buffer.sobrescritos(inst));
+    });
+    const double t_recente = ns_por_chamada(iteracoes, [&] {
+        return static_cast<std::uint64_t>(buffer.get_posicao_recente().i_pos_x);
+    });
+    // a cópia inteira é cara: menos iterações nas capacidades grandes
+    const std::size_t it_copia = iteracoes / capacidade > 10 ? iteracoes / capacidade : 10;
+    const double t_todas = ns_por_chamada(it_copia, [&] {
+        return static_cast<std::uint64_t>(buffer.get_todas().size());
+    });
+
+    parar.store(true);
+    if (escritor.joinable()) escritor.join();
+
+    std::printf("%10zu  %-9s  %12.1f  %12.1f  %14.0f\n", capacidade, com_escritor ? "ativo" : "parado",
+                t_inst, t_recente, t_todas);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t iteracoes = 2000000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iteracoes") == 0 && i + 1 < argc) {
+            iteracoes = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Uso: %s [--iteracoes N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("%10s  %-9s  %12s  %12s  %14s\n", "capacidade", "escritor",
+                "inst. (ns)", "recente (ns)", "get_todas (ns)");
+    for (std::size_t capacidade : {std::size_t(100), std::size_t(60000), std::size_t(600000)}) {
+        medir(capacidade, iteracoes, false);
+        medir(capacidade, iteracoes, true);
+    }
+    return 0;
+}
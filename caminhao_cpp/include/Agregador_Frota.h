@@ -0,0 +1,143 @@
+#ifndef AGREGADOR_FROTA_H
+#define AGREGADOR_FROTA_H
+
+#include "Cliente_MQTT.h"
+#include "Roteador_Topicos.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file Agregador_Frota.h
+ * @brief Declaração da classe AgregadorFrota.
+ *
+ * @objetivo Manter uma tabela compacta com o estado de toda a frota
+ * (posição, modo, falhas ativas) e publicar para as interfaces um único
+ * feed periódico, só com o que mudou. Assim as interfaces não assinam
+ * os tópicos brutos de cada caminhão: o tráfego e a CPU do lado Python
+ * acompanham a taxa de mudança, e não caminhões x 20 Hz.
+ *
+ * @entradas (Inputs)
+ * 1. atr/<id>/sensor/raw -> posição, ângulo, temperatura, falhas elétrica/hidráulica
+ * 2. atr/<id>/act        -> "modo", se presente (sem ele, o campo fica fora do feed)
+ * 3. atr/sim/remove      -> retira o caminhão da tabela; mensagens atrasadas
+ *    desse id são descartadas até um atr/sim/spawn com o mesmo id
+ *
+ * @saidas (Outputs)
+ * 1. atr/frota/delta  -> a cada quadro, só os campos que mudaram além da
+ *    tolerância desde o último envio (quadro vazio não é publicado).
+ * 2. atr/frota/estado -> quadro-chave (retido): a tabela inteira, para
+ *    quem entra depois ou perdeu um delta.
+ *
+ * @mecanismo (Interno)
+ * - Estado em SoA: um vetor por campo, com o último valor recebido e o
+ *   último valor enviado. Um campo entra no delta quando difere do
+ *   enviado além da tolerância (posição, ângulo, temperatura) ou quando
+ *   muda (modo, falhas); comparar com o enviado, e não com o anterior,
+ *   evita deriva acumulada.
+ * - Caminhões novos chegam pelas assinaturas curinga; na primeira
+ *   mensagem são registradas rotas literais (atr/<id>/...) com o índice
+ *   do caminhão, que têm prioridade sobre o curinga: dali em diante a
+ *   trie já entrega o índice, sem busca por id.
+ * - Telemetria usa a política ULTIMO_VALOR: se o agregador atrasar, só
+ *   a amostra mais nova de cada caminhão fica na fila.
+ * - Caminhão removido: as rotas literais dele ficam registradas sem
+ *   tratador (marca de removido), e as mensagens que ainda chegarem são
+ *   descartadas pela própria trie, sem recriá-lo no feed.
+ * - Ids vêm do tópico e são escapados ao entrar no JSON; ids com '/',
+ *   '+' ou '#' são ignorados.
+ * - Uma thread só (a do chamador de executar()): sem locks na tabela.
+ *
+ * Formato (JSON):
+ *   {"quadro":N,"base":N-1,"t":<s epoch>,
+ *    "c":{"<id>":{"x":..,"y":..,"ang":..,"temp":..,"modo":"automatico","falhas":<bits>}},
+ *    "rem":["<id>",...]}
+ *   Quadro-chave: "chave":true, todos os caminhões e campos, "base" ausente.
+ *   Bits de "falhas": 1 elétrica, 2 hidráulica, 4 térmica (>falha_on), 8 sem dados.
+ */
+
+namespace atr {
+
+struct ConfigAgregador {
+    double hz = 5.0;                 // quadros de delta por segundo
+    double intervalo_chave_s = 5.0;  // período do quadro-chave retido
+    double tol_pos  = 0.05;          // unidades
+    double tol_ang  = 0.5;           // graus
+    double tol_temp = 0.5;           // °C
+    double timeout_s = 1.0;          // sem amostras há mais que isso: bit "sem dados"
+};
+
+class AgregadorFrota {
+public:
+    static constexpr std::uint8_t FALHA_ELETRICA   = 1;
+    static constexpr std::uint8_t FALHA_HIDRAULICA = 2;
+    static constexpr std::uint8_t FALHA_TERMICA    = 4;
+    static constexpr std::uint8_t SEM_DADOS        = 8;
+
+    AgregadorFrota(ClienteMQTT& cliente, const ConfigAgregador& cfg);
+
+    AgregadorFrota(const AgregadorFrota&) = delete;
+    AgregadorFrota& operator=(const AgregadorFrota&) = delete;
+
+    /** @brief Conecta (com retentativas) e assina os tópicos da frota. */
+    void iniciar();
+
+    /** @brief Consome mensagens e publica quadros até 'parar' ficar true. */
+    void executar(const std::atomic<bool>& parar);
+
+    // leitura segura de outras threads (relatórios)
+    std::size_t caminhoes() const { return m_caminhoes.load(std::memory_order_relaxed); }
+    std::uint64_t quadros() const { return m_quadro.load(std::memory_order_relaxed); }
+    std::uint64_t bytes_entrada() const { return m_bytes_entrada.load(std::memory_order_relaxed); }
+    std::uint64_t bytes_saida() const { return m_bytes_saida.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    ClienteMQTT& m_cli;
+    ConfigAgregador m_cfg;
+    RoteadorTopicos m_rotas;
+
+    std::atomic<std::size_t> m_caminhoes{0};
+    std::atomic<std::uint64_t> m_quadro{0};
+    std::atomic<std::uint64_t> m_bytes_entrada{0};
+    std::atomic<std::uint64_t> m_bytes_saida{0};
+
+    // ---- estado da frota (SoA) ----
+    static constexpr std::uint8_t MODO_DESCONHECIDO = 0xFF;
+
+    std::vector<std::string> m_id;
+    std::vector<double> m_x, m_y, m_ang, m_temp;
+    std::vector<std::uint8_t> m_modo, m_falhas;
+    std::vector<Clock::time_point> m_t_ultima;
+    // último valor enviado (o que as interfaces têm)
+    std::vector<double> m_env_x, m_env_y, m_env_ang, m_env_temp;
+    std::vector<std::uint8_t> m_env_modo, m_env_falhas;
+    std::vector<std::uint8_t> m_novo; // nunca enviado: todos os campos
+    std::vector<std::string> m_removidos; // desde o último quadro
+
+    std::string m_saida; // reaproveitado entre quadros
+
+    void amostra_sensor(int indice, const MensagemMQTT& msg);
+    void atuadores(int indice, const MensagemMQTT& msg);
+    void tratar_spawn(const std::string& payload);
+    void tratar_remove(const std::string& payload);
+    int indice_de(std::string_view id);
+    int indice_do_topico(const std::string& topico); // cria o caminhão se preciso
+    void registrar_rotas(std::size_t indice);
+    void remover(std::size_t indice);
+    void marcar_removido(const std::string& id);
+
+    void atualizar_timeouts(Clock::time_point agora);
+    bool montar_quadro(bool chave); // false: delta vazio
+    void publicar_quadro(bool chave);
+};
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef ARENA_TAREFA_H
+#define ARENA_TAREFA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * @file Arena_Tarefa.h
+ * @brief Declaração da classe ArenaTarefa.
+ *
+ * @objetivo Memória temporária de um ciclo de tarefa: tudo o que é
+ * alocado durante o ciclo (vetores std::pmr, cópias do buffer, listas
+ * auxiliares) sai de um bloco fixo, e reiniciar() devolve o bloco
+ * inteiro de uma vez no fim do ciclo, sem free individual.
+ *
+ * Se o ciclo estourar o bloco, o excedente vem do recurso padrão
+ * (heap) — o que aparece no Contador de Alocações e indica que o
+ * tamanho da arena deve ser aumentado.
+ *
+ * reiniciar() invalida tudo o que saiu da arena: só quem é dono do
+ * ciclo pode chamá-lo. Código reentrante (ex.: uma publicação cujo
+ * callback publica de novo) usa uma arena local à chamada, nunca uma
+ * arena compartilhada da thread.
+ */
+
+template <std::size_t Bytes>
+class ArenaTarefa {
+public:
+    ArenaTarefa()
+        : m_recurso(m_bloco, Bytes, std::pmr::get_default_resource()) {}
+
+    ArenaTarefa(const ArenaTarefa&) = delete;
+    ArenaTarefa& operator=(const ArenaTarefa&) = delete;
+
+    std::pmr::memory_resource* recurso() { return &m_recurso; }
+
+    /** @brief Fim do ciclo: tudo o que foi alocado na arena é descartado. */
+    void reiniciar() { m_recurso.release(); }
+
+private:
+    alignas(std::max_align_t) std::byte m_bloco[Bytes];
+    std::pmr::monotonic_buffer_resource m_recurso;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef BUFFER_CIRCULAR_H
+#define BUFFER_CIRCULAR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#include "Maquina_Estados.h"
+#include "Rastreamento.h"
+
+/**
+ * @file Buffer_Circular.h
+ * @brief Declaração da classe BufferCircular.
+ *
+ * @objetivo Armazenar as últimas posições tratadas do caminhão
+ * (escritas pelo Tratamento de Sensores) e os setpoints de navegação
+ * (escritos pelo Planejamento de Rota), para leitura pelas demais tarefas.
+ * Quando cheio, a posição mais antiga é sobrescrita.
+ *
+ * O mutex interno é exposto (get_mutex) para que produtor e consumidores
+ * façam o lock externo e usem wait_for_new_data / notify_all_consumers.
+ *
+ * @mecanismo (Leitura sem cópia)
+ * Há um único escritor (Tratamento de Sensores), que nunca bloqueia. Cada
+ * posição recebe um número de sequência; o escritor anuncia a sequência
+ * que vai sobrescrever ('iniciados') antes de gravar o slot e a publica
+ * ('escritos') depois. instantaneo() devolve o anel como até dois trechos
+ * contíguos, lidos no lugar; ao terminar a leitura, sobrescritos(inst)
+ * diz quantas posições iniciais o escritor alcançou nesse meio-tempo e
+ * devem ser descartadas (validação no estilo seqlock). O custo de obter
+ * o instantâneo é O(1), independente da capacidade.
+ *
+ * Como o leitor pode ler um slot enquanto o escritor o grava, os campos
+ * de cada slot são atômicos relaxados (em x86-64/ARM64 a leitura é um
+ * load comum): a leitura concorrente não é corrida de dados no modelo
+ * de memória do C++. Um slot lido no meio de uma escrita pode misturar
+ * campos de duas posições; sobrescritos() é quem diz para descartá-lo.
+ * bench/bench_buffer_circular.cpp mede o custo do leitor por capacidade.
+ *
+ * @mecanismo (Modo e comandos)
+ * O modo (e_defeito / e_automatico) é escrito só pela Lógica de Comando
+ * e lido a cada ciclo pela Navegação e pelo Coletor: é um atômico, sem
+ * lock. Os comandos do operador (Coletor -> Lógica) vão em uma fila de
+ * até 7 comandos empacotada em um único atômico de 32 bits (4 bits de
+ * contagem + 4 bits por comando), preservando a ordem sem alocar.
+ */
+
+class BufferCircular {
+public:
+    struct PosicaoData {
+        double i_pos_x    = 0.0;
+        double i_pos_y    = 0.0;
+        double i_angulo_x = 0.0;
+        atr::Carimbo carimbo; // ingresso da amostra que gerou a posição
+    };
+
+    struct SetpointsNavegacao {
+        double set_velocidade  = 0.0;
+        double set_pos_angular = 0.0;
+        atr::Carimbo origem;             // carimbo da posição usada no cálculo
+        std::int64_t t_calculado_ns = 0; // instante (monotônico) do cálculo
+    };
+
+    /** @brief Saída do Controle de Navegação, usada pela Lógica em automático. */
+    struct ControleNavegacao {
+        double velocidade      = 0.0; // ação sobre a velocidade: aceleração em % (-100..100)
+        double posicao_angular = 0.0; // direção absoluta comandada (graus)
+        atr::Carimbo origem;          // carimbo da posição/setpoint que a gerou
+    };
+
+    /** @brief Slot do anel: uma PosicaoData com campos atômicos (relaxados). */
+    class Slot {
+    public:
+        PosicaoData ler() const {
+            PosicaoData p;
+            p.i_pos_x               = x_.load(std::memory_order_relaxed);
+            p.i_pos_y               = y_.load(std::memory_order_relaxed);
+            p.i_angulo_x            = ang_.load(std::memory_order_relaxed);
+            p.carimbo.seq           = seq_.load(std::memory_order_relaxed);
+            p.carimbo.t_ingresso_ns = t_ns_.load(std::memory_order_relaxed);
+            return p;
+        }
+
+        void gravar(const PosicaoData& p) {
+            x_.store(p.i_pos_x, std::memory_order_relaxed);
+            y_.store(p.i_pos_y, std::memory_order_relaxed);
+            ang_.store(p.i_angulo_x, std::memory_order_relaxed);
+            seq_.store(p.carimbo.seq, std::memory_order_relaxed);
+            t_ns_.store(p.carimbo.t_ingresso_ns, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<double> x_{0.0}, y_{0.0}, ang_{0.0};
+        std::atomic<std::uint64_t> seq_{0};
+        std::atomic<std::int64_t> t_ns_{0};
+
+        static_assert(std::atomic<double>::is_always_lock_free, "slot precisa ser lock-free");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "slot precisa ser lock-free");
+    };
+
+    /**
+     * @brief Visão das posições no próprio anel, da mais antiga para a mais
+     * recente: parte1 seguida de parte2 (vazia se o anel não deu a volta).
+     * Cada acesso lê o slot no lugar e devolve a posição por valor.
+     */
+    struct Instantaneo {
+        const Slot* parte1 = nullptr;
+        std::size_t tam1 = 0;
+        const Slot* parte2 = nullptr;
+        std::size_t tam2 = 0;
+        std::uint64_t seq_inicio = 0; // sequência de parte1[0]
+
+        std::size_t tamanho() const { return tam1 + tam2; }
+
+        PosicaoData operator[](std::size_t i) const {
+            return i < tam1 ? parte1[i].ler() : parte2[i - tam1].ler();
+        }
+
+        template <typename F>
+        void para_cada(F&& f) const {
+            for (std::size_t i = 0; i < tam1; ++i) f(parte1[i].ler());
+            for (std::size_t i = 0; i < tam2; ++i) f(parte2[i].ler());
+        }
+    };
+
+    explicit BufferCircular(std::size_t capacidade = 200);
+
+    /** @brief Escreve uma nova posição tratada (sobrescreve a mais antiga se cheio). */
+    void set_posicao_tratada(const PosicaoData& pos);
+
+    /** @brief Posição mais recente (sem remover). Vazio -> PosicaoData{}. */
+    PosicaoData get_posicao_recente() const;
+    PosicaoData get_posicao_tratada() const { return get_posicao_recente(); }
+
+    /** @brief Cópia de todas as posições, da mais antiga para a mais recente. */
+    std::vector<PosicaoData> get_todas() const;
+
+    /**
+     * @brief Mesma cópia de get_todas(), mas em um vetor do recurso
+     * informado (ex.: a ArenaTarefa do ciclo), sem tocar no heap.
+     */
+    std::pmr::vector<PosicaoData> get_todas(std::pmr::memory_resource* recurso) const;
+
+    /**
+     * @brief Copia as posições (da mais antiga para a mais recente) para
+     * um destino do chamador, sem alocar.
+     * @param destino Área com espaço para 'maximo' posições.
+     * @return Quantidade copiada (as 'maximo' mais recentes, se não couber tudo).
+     */
+    std::size_t copiar_todas(PosicaoData* destino, std::size_t maximo) const;
+
+    /** @brief Instantâneo sem cópia e sem bloquear o escritor (O(1)). */
+    Instantaneo instantaneo() const;
+
+    /**
+     * @brief Chamar após ler o instantâneo: quantas posições do início dele
+     * podem ter sido sobrescritas durante a leitura (descarte-as).
+     */
+    std::size_t sobrescritos(const Instantaneo& inst) const;
+
+    std::size_t tamanho() const;
+    std::size_t capacidade() const { return capacidade_; }
+
+    /** @brief Total de posições já escritas (sequência da próxima). */
+    std::uint64_t total_escritos() const { return escritos_.load(std::memory_order_acquire); }
+
+    void set_setpoints_navegacao(const SetpointsNavegacao& sp);
+    SetpointsNavegacao get_setpoints_navegacao() const;
+
+    void set_controle_navegacao(const ControleNavegacao& c);
+    ControleNavegacao get_controle_navegacao() const;
+
+    // ---- modo (escrito pela Lógica de Comando, lido sem lock) ----
+    void set_modo(atr::ModoOperacao modo) { modo_.store(modo, std::memory_order_release); }
+    atr::ModoOperacao get_modo() const { return modo_.load(std::memory_order_acquire); }
+    bool e_defeito() const { return get_modo() == atr::ModoOperacao::DEFEITO; }
+    bool e_automatico() const { return get_modo() == atr::ModoOperacao::AUTOMATICO; }
+
+    // ---- comandos do operador (Coletor -> Lógica de Comando) ----
+    /** @return false se a fila (7 comandos) estiver cheia. */
+    bool enviar_comando(atr::ComandoOperador cmd);
+
+    /** @brief Retira todos os comandos pendentes, na ordem de envio. */
+    template <typename F>
+    void retirar_comandos(F&& f) {
+        std::uint32_t pacote = comandos_.exchange(0, std::memory_order_acq_rel);
+        const std::uint32_t n = pacote & 0xFu;
+        for (std::uint32_t k = 0; k < n; ++k) {
+            pacote >>= 4;
+            f(static_cast<atr::ComandoOperador>(pacote & 0xFu));
+        }
+    }
+
+    std::mutex& get_mutex();
+    void notify_all_consumers();
+    void wait_for_new_data(std::unique_lock<std::mutex>& lock);
+
+private:
+    std::unique_ptr<Slot[]> buffer_;
+    std::size_t capacidade_;
+
+    // sequência: a posição de número s fica no slot s % capacidade_
+    std::atomic<std::uint64_t> iniciados_{0}; // escrita anunciada (slot sendo gravado)
+    std::atomic<std::uint64_t> escritos_{0};  // escrita publicada
+
+    SetpointsNavegacao setpoints_{};
+    ControleNavegacao controle_{};
+    mutable std::mutex setpoints_mutex_; // setpoints e controle
+
+    std::atomic<atr::ModoOperacao> modo_{atr::ModoOperacao::MANUAL};
+    std::atomic<std::uint32_t> comandos_{0};
+    static_assert(std::atomic<atr::ModoOperacao>::is_always_lock_free, "modo precisa ser lock-free");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "fila de comandos precisa ser lock-free");
+
+    std::mutex mutex_;
+    std::condition_variable cond_var_;
+};
+
+#endif
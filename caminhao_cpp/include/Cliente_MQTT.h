@@ -0,0 +1,190 @@
+#ifndef CLIENTE_MQTT_H
+#define CLIENTE_MQTT_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file Cliente_MQTT.h
+ * @brief Declaração da interface ClienteMQTT e do seletor de transporte.
+ *
+ * @objetivo Abstrair o subconjunto de 'mqtt::async_client' que as tarefas
+ * usam (conectar, assinar, publicar, consumir) para que o núcleo possa
+ * trocar, na inicialização, entre o Paho (broker real) e um broker em
+ * processo ('local'), usado em testes de carga herméticos sem rede.
+ *
+ * O transporte local implementa o mesmo casamento de tópicos do MQTT
+ * (curingas '+' e '#') e mensagens retidas, entregando tudo dentro
+ * do próprio processo.
+ *
+ * Sessão: conectar_sessao() conecta e assina todos os filtros da tarefa
+ * em um único pedido, tentando de novo com backoff exponencial (com
+ * jitter, para que a frota não reconecte em sincronia após uma queda do
+ * broker). Depois disso, uma conexão perdida é refeita em segundo plano
+ * com a mesma política, e as assinaturas são refeitas em lote.
+ */
+
+namespace atr {
+
+struct MensagemMQTT {
+    std::string topico;
+    std::string payload;
+    int qos = 0;
+    std::chrono::steady_clock::time_point recebida{}; // chegada ao cliente (idade na fila)
+};
+
+using MensagemPtr = std::shared_ptr<const MensagemMQTT>;
+
+enum class TransporteMQTT {
+    PAHO,  // broker externo via paho.mqtt.cpp
+    LOCAL  // broker em processo (BrokerLocal)
+};
+
+/**
+ * @brief Define o transporte usado por criar_cliente_mqtt().
+ * Deve ser chamado no main, antes de criar as threads.
+ */
+void definir_transporte_mqtt(TransporteMQTT transporte);
+TransporteMQTT transporte_mqtt();
+
+/**
+ * @brief Converte "paho" / "local" no enum. Retorna false se desconhecido.
+ */
+bool transporte_de_texto(const std::string& texto, TransporteMQTT& saida);
+
+/**
+ * @brief Monta a URI do broker ("tcp://<host>:<porta>").
+ */
+std::string uri_broker(const std::string& host = "localhost", int porta = 1883);
+
+/**
+ * @brief Verifica se 'topico' casa com o filtro MQTT 'filtro' ('+' e '#').
+ */
+bool topico_corresponde(const std::string& filtro, const std::string& topico);
+
+struct Assinatura {
+    std::string filtro;
+    int qos = 0;
+};
+
+/**
+ * @brief Backoff exponencial das tentativas de (re)conexão: a espera da
+ * tentativa k é sorteada em [teto/2, teto], com teto = min(maximo, inicial * 2^k).
+ */
+struct PoliticaReconexao {
+    std::chrono::milliseconds inicial{100};
+    std::chrono::milliseconds maximo{5000};
+
+    std::chrono::milliseconds espera(int tentativa) const;
+};
+
+struct CaixaEntrada; // fila/callback de entrega (interno ao .cpp)
+class PoolMensagens;
+
+class ClienteMQTT {
+public:
+    using Callback = std::function<void(const MensagemPtr&)>;
+
+    ClienteMQTT();
+    virtual ~ClienteMQTT();
+
+    ClienteMQTT(const ClienteMQTT&) = delete;
+    ClienteMQTT& operator=(const ClienteMQTT&) = delete;
+
+    // ---- transporte (bloqueiam até a confirmação, como o antigo ->wait()) ----
+    virtual void conectar() = 0;
+    virtual void desconectar() = 0;
+    virtual bool conectado() const = 0;
+    virtual void assinar(const std::string& filtro, int qos) = 0;
+
+    /** @brief Assina vários filtros em um único pedido ao broker. */
+    virtual void assinar_lote(const std::vector<Assinatura>& lote) = 0;
+
+    virtual void cancelar_assinatura(const std::string& filtro) = 0;
+    virtual void publicar(const std::string& topico, const std::string& payload,
+                          int qos, bool retido = false) = 0;
+
+    // ---- sessão com reconexão ----
+
+    /**
+     * @brief Conecta e assina 'lote', repetindo até conseguir (não desiste
+     * se o broker ainda não subiu). A partir daí, quedas de conexão são
+     * tratadas em segundo plano: reconexão com a mesma política e
+     * reassinatura do lote.
+     * @param nome Prefixo dos logs (ex.: "Monitor 1").
+     */
+    void conectar_sessao(const std::vector<Assinatura>& lote, const std::string& nome,
+                         const PoliticaReconexao& politica = {});
+
+    // ---- consumo: fila interna (modo consumer) ou callback ----
+
+    /** @brief Passa a enfileirar as mensagens recebidas (start_consuming). */
+    void iniciar_consumo();
+
+    /** @brief Para de enfileirar e acorda quem estiver em consumir(). */
+    void parar_consumo();
+
+    /**
+     * @brief Espera uma mensagem por até 'timeout'.
+     * @return true se 'msg' recebeu uma mensagem.
+     */
+    bool consumir_por(MensagemPtr& msg, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Bloqueia até chegar uma mensagem.
+     * @return nullptr se o consumo foi parado.
+     */
+    MensagemPtr consumir();
+
+    /**
+     * @brief Entrega as mensagens direto no callback (thread do transporte),
+     * em vez de enfileirá-las.
+     */
+    void definir_callback(Callback cb);
+
+    /**
+     * @brief Mensagens de tópicos ULTIMO_VALOR (Politicas_Entrega.h) que
+     * foram substituídas na fila por uma mais nova antes de serem consumidas.
+     */
+    std::uint64_t substituidas() const;
+
+protected:
+    /**
+     * @brief Chamado por conectar_sessao() após a primeira conexão: o
+     * transporte passa a refazer a sessão sozinho se a conexão cair.
+     * O transporte local nunca perde a conexão (padrão: nada a fazer).
+     */
+    virtual void manter_sessao(const std::vector<Assinatura>& lote,
+                               const std::string& nome, const PoliticaReconexao& politica);
+
+    /** @brief Mensagem do pool do cliente, para o transporte preencher. */
+    std::shared_ptr<MensagemMQTT> nova_mensagem();
+
+    /** @brief Chamado pelo transporte a cada mensagem recebida. */
+    void entregar(const MensagemPtr& msg);
+
+    /** @brief Desliga a entrega e espera callbacks em andamento (destrutores). */
+    void encerrar_entrega();
+
+    std::shared_ptr<CaixaEntrada> caixa() const { return m_caixa; }
+
+private:
+    std::shared_ptr<CaixaEntrada> m_caixa;
+    std::unique_ptr<PoolMensagens> m_pool;
+};
+
+/**
+ * @brief Cria um cliente do transporte selecionado em definir_transporte_mqtt().
+ * @param uri       URI do broker (ignorada pelo transporte local).
+ * @param client_id Identificador do cliente.
+ */
+std::unique_ptr<ClienteMQTT> criar_cliente_mqtt(const std::string& uri,
+                                                const std::string& client_id);
+
+} // namespace atr
+
+#endif
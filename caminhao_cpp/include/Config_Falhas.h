@@ -0,0 +1,32 @@
+#ifndef CONFIG_FALHAS_H
+#define CONFIG_FALHAS_H
+
+#include <chrono>
+
+/**
+ * @file Config_Falhas.h
+ * @brief Limiares de falha do Monitoramento de Falhas.
+ *
+ * @objetivo Ser a única fonte dos limiares de temperatura (com histerese)
+ * e do timeout de sensores. O Monitoramento de Falhas decide os eventos
+ * com eles; o Agregador da Frota e a Previsão Térmica os reutilizam, para
+ * que o bit "térmica" do feed da frota e o horizonte da previsão mudem
+ * junto com o DEFEITO_TERMICO do monitor.
+ */
+
+namespace atr {
+
+struct FaultConfig {
+    int alerta_on  = 95;    // sobe alerta térmico
+    int alerta_off = 90;    // desce alerta térmico
+    int falha_on   = 120;   // sobe falha térmica
+    int falha_off  = 115;   // desce falha térmica
+    // timeout de sensores; 0 = desligado. O simulador só publica ao mudar
+    // de célula (caminhão parado fica em silêncio): ligar só com uma
+    // fonte periódica (ATR_MONITOR_TIMEOUT_MS, ex.: simulador_mina --publicar-sempre)
+    std::chrono::milliseconds timeout{0};
+};
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef CONTADOR_ALOCACOES_H
+#define CONTADOR_ALOCACOES_H
+
+#include <cstdint>
+
+/**
+ * @file Contador_Alocacoes.h
+ * @brief Contadores de alocação no heap, por thread.
+ *
+ * @objetivo Medir quantas alocações cada tarefa faz por mensagem em
+ * regime. Com a opção de CMake ATR_CONTAR_ALOCACOES=ON, os operadores
+ * globais new/delete são substituídos por versões que contam (por
+ * thread) antes de chamar malloc/free; sem ela, os contadores ficam
+ * sempre em zero e contador_alocacoes_ativo() retorna false.
+ */
+
+namespace atr {
+
+struct ContagemAlocacoes {
+    std::uint64_t alocacoes = 0;
+    std::uint64_t bytes     = 0;
+};
+
+/** @brief Alocações feitas pela thread chamadora desde o seu início. */
+ContagemAlocacoes alocacoes_da_thread();
+
+/** @brief true se o binário foi compilado com ATR_CONTAR_ALOCACOES. */
+bool contador_alocacoes_ativo();
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef HISTORICO_TRAJETORIA_H
+#define HISTORICO_TRAJETORIA_H
+
+#include "Buffer_Circular.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file Historico_Trajetoria.h
+ * @brief Declaração da classe HistoricoTrajetoria.
+ *
+ * @objetivo Guardar a trajetória do caminhão em várias resoluções, para
+ * que a interface e a gestão consultem longos períodos (ex.: a última
+ * hora) sem o coletor precisar reprocessar logs:
+ *  - bruto:  taxa plena, últimos segundos (o próprio BufferCircular);
+ *  - 1 Hz:   min/max/média por segundo;
+ *  - 0,1 Hz: min/max/média a cada 10 s.
+ *
+ * @mecanismo (Interno)
+ * Os agregados de 1 s e de 10 s são mantidos incrementalmente a cada
+ * amostra (O(1)). Cada nível é um anel de capacidade fixa com os
+ * intervalos fechados, mais o agregado em aberto (o intervalo atual,
+ * parcial), que as consultas devolvem como último ponto.
+ * O escritor espera pelo mutex só quando fecha um agregado (no máximo
+ * 1 vez por segundo). Nas demais amostras ele só tenta (try_lock)
+ * atualizar o agregado em aberto: se uma consulta estiver com o mutex,
+ * a atualização fica para a próxima amostra. As consultas custam
+ * O(pontos devolvidos).
+ *
+ * @entradas (Inputs)
+ * 1. registrar(): posição tratada (Tratamento de Sensores).
+ *
+ * @saidas (Outputs)
+ * 1. consultar(): pontos da janela pedida, do mais antigo ao mais recente
+ *    (servidos via MQTT pela tarefa de consulta do histórico).
+ */
+
+struct ConfigHistorico {
+    double taxa_hz        = 20.0;    // taxa nominal das amostras brutas
+    double janela_bruta_s = 10.0;    // capacidade do BufferCircular
+    double janela_1hz_s   = 3600.0;  // 1 h de agregados de 1 s
+    double janela_01hz_s  = 86400.0; // 24 h de agregados de 10 s
+
+    std::size_t capacidade_bruta() const;
+
+    /**
+     * @brief Lê ATR_HISTORICO_TAXA_HZ, ATR_HISTORICO_BRUTO_S,
+     * ATR_HISTORICO_1HZ_S e ATR_HISTORICO_01HZ_S (valores ausentes ou
+     * inválidos mantêm o padrão).
+     */
+    static ConfigHistorico do_ambiente();
+};
+
+class HistoricoTrajetoria {
+public:
+    struct Estatistica {
+        double min   = 0.0;
+        double max   = 0.0;
+        double media = 0.0;
+    };
+
+    /** @brief Um ponto de qualquer nível (amostra bruta: n = 1, min = max = média). */
+    struct Agregado {
+        double t_inicio = 0.0;  // s, relógio monotônico do histórico
+        double duracao  = 0.0;  // s (0 para amostra bruta)
+        std::uint32_t n = 0;    // amostras agregadas
+        Estatistica x;
+        Estatistica y;
+        double ang_medio = 0.0; // média circular (graus)
+        bool aberto = false;    // intervalo atual, ainda recebendo amostras
+    };
+
+    enum class Nivel { BRUTO, SEG_1, SEG_10 };
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param bruto Buffer do caminhão (nível bruto); deve ter a capacidade
+     *              de cfg.capacidade_bruta().
+     */
+    HistoricoTrajetoria(const BufferCircular& bruto, const ConfigHistorico& cfg);
+
+    /** @brief Agrega uma posição (único escritor, mesma thread do buffer). */
+    void registrar(const BufferCircular::PosicaoData& pos, Clock::time_point t);
+
+    /**
+     * @brief Pontos dos últimos 'janela_s' segundos, do mais antigo ao mais
+     * recente. Usa o nível mais fino que cobre a janela em até 'maximo'
+     * pontos; se nenhum couber, o mais grosso, truncado aos mais recentes.
+     * Nos níveis agregados, o último ponto é o intervalo em aberto.
+     * @param nivel_usado (opcional) recebe o nível escolhido.
+     * @return Quantidade escrita em 'destino'.
+     */
+    std::size_t consultar(double janela_s, Agregado* destino, std::size_t maximo,
+                          Nivel* nivel_usado = nullptr) const;
+
+    /** @brief Segundos do relógio do histórico para o instante t. */
+    double segundos(Clock::time_point t) const;
+
+private:
+    class Anel {
+    public:
+        explicit Anel(std::size_t capacidade) : m_dados(capacidade ? capacidade : 1) {}
+        void inserir(const Agregado& a) { m_dados[m_total++ % m_dados.size()] = a; }
+        std::size_t tamanho() const { return m_total < m_dados.size() ? m_total : m_dados.size(); }
+        // i = 0 é o mais recente
+        const Agregado& recente(std::size_t i) const { return m_dados[(m_total - 1 - i) % m_dados.size()]; }
+    private:
+        std::vector<Agregado> m_dados;
+        std::uint64_t m_total = 0;
+    };
+
+    // acumulador do agregado em aberto de um nível
+    struct Acumulador {
+        std::int64_t balde = -1; // índice do intervalo (t / período)
+        std::uint32_t n = 0;
+        double xmin = 0, xmax = 0, xsoma = 0;
+        double ymin = 0, ymax = 0, ysoma = 0;
+        double cos_soma = 0, sin_soma = 0;
+
+        void somar(const Agregado& a);
+        Agregado fechar(double periodo, bool aberto = false) const;
+    };
+
+    const BufferCircular& m_bruto;
+    ConfigHistorico m_cfg;
+    Clock::time_point m_t0;
+
+    Acumulador m_acc_1s;
+    Acumulador m_acc_10s;
+
+    mutable std::mutex m_mutex; // protege os anéis e os agregados em aberto
+    Anel m_anel_1s;
+    Anel m_anel_10s;
+    Agregado m_aberto_1s;  // n = 0: nenhuma amostra ainda
+    Agregado m_aberto_10s;
+    std::atomic<double> m_t_ultima{0.0}; // s da amostra bruta mais recente
+
+    void acumular(Acumulador& acc, const Agregado& a, double periodo, bool& fechou, Agregado& fechado);
+    std::size_t copiar_nivel(const Anel& anel, const Agregado& aberto, double desde,
+                             Agregado* destino, std::size_t maximo) const;
+    std::size_t copiar_bruto(double janela_s, Agregado* destino, std::size_t maximo) const;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef IPC_MANAGER_H
+#define IPC_MANAGER_H
+
+#include <string>
+
+/**
+ * @file IPC_Manager.h
+ * @brief Declaração da classe IpcManager.
+ *
+ * @objetivo Abstrair a Comunicação entre Processos (IPC) entre esta
+ * instância do caminhão e o processo 'interface_local' correspondente.
+ * Usada pela 'coletor_dados' para receber comandos do operador
+ * ("c_automatico", "c_man", "c_rearme") e devolver o estado.
+ */
+
+class IpcManager {
+public:
+    explicit IpcManager(int id);
+
+    /** @brief Próximo comando do operador; "" se não houver. */
+    std::string receber_comando();
+
+    /** @brief Envia o estado atual (posição, modo, falhas) à interface local. */
+    void enviar_estado(const std::string& estado);
+
+private:
+    int m_id;
+};
+
+#endif
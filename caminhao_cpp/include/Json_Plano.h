@@ -0,0 +1,44 @@
+#ifndef JSON_PLANO_H
+#define JSON_PLANO_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @file Json_Plano.h
+ * @brief Leitura de campos de um JSON plano, sem montar DOM.
+ *
+ * @objetivo Extrair números/booleanos das amostras de sensor
+ * ({"i_posicao_x": 1.2, "i_falha_eletrica": false, ...}) direto do
+ * payload, sem a árvore de objetos (e as alocações) do nlohmann::json.
+ * Pensado para o caminho quente de telemetria; mensagens de comando e
+ * de configuração continuam usando nlohmann::json.
+ *
+ * Limitação: a chave é procurada em qualquer nível. Use apenas com
+ * payloads planos (sem objetos aninhados com as mesmas chaves).
+ *
+ * Para quem monta JSON à mão (snprintf / append), json_anexar_texto()
+ * escreve um texto vindo de fora (ex.: id do caminhão tirado do tópico)
+ * como string JSON válida.
+ */
+
+namespace atr {
+
+/** @return true se a chave existe e o valor é um número válido. */
+bool json_numero(std::string_view json, std::string_view chave, double& saida);
+
+/** @return true se a chave existe e o valor é true/false (ou 0/1). */
+bool json_booleano(std::string_view json, std::string_view chave, bool& saida);
+
+/** @return true se a chave existe e o valor é uma string (sem escapes). */
+bool json_texto(std::string_view json, std::string_view chave, std::string_view& saida);
+
+/**
+ * @brief Anexa 'texto' a 'saida' entre aspas, com '"', '\\' e caracteres de
+ * controle escapados. Não aloca se 'saida' já tiver capacidade.
+ */
+void json_anexar_texto(std::string& saida, std::string_view texto);
+
+} // namespace atr
+
+#endif
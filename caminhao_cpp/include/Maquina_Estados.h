@@ -0,0 +1,265 @@
+#ifndef MAQUINA_ESTADOS_H
+#define MAQUINA_ESTADOS_H
+
+#include "Notificador_Eventos.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+/**
+ * @file Maquina_Estados.h
+ * @brief Máquina de estados da Lógica de Comando (manual / automático / defeito).
+ *
+ * @objetivo Decidir o modo do caminhão a partir dos eventos do
+ * Monitoramento de Falhas (TipoEvento) e dos comandos do operador
+ * ("c_automatico", "c_man", "c_rearme"), a cada ciclo de controle.
+ *
+ * @mecanismo (Interno)
+ * - As regras ficam em uma única função constexpr (transicao). A tabela
+ *   estado x entrada é gerada a partir dela em tempo de compilação; em
+ *   execução, cada transição é um acesso a vetor (O(1), sem alocação,
+ *   sem desvio por tipo de entrada).
+ * - Eventos e comandos compartilham o mesmo espaço de entradas: primeiro
+ *   os TipoEvento, depois os ComandoOperador.
+ * - As propriedades da tabela (defeito sempre vence, automático só por
+ *   comando, rearme só após normalização, ...) são verificadas com
+ *   static_assert para toda combinação estado x entrada: uma regra
+ *   errada não compila.
+ *
+ * O modo publicado (ModoOperacao) tem só três valores. Internamente o
+ * defeito tem dois estados: DEFEITO (falha ativa, rearme recusado) e
+ * DEFEITO_NORMALIZADO (o monitor já informou a normalização e o rearme é
+ * aceito). NORMALIZACAO não diz qual falha normalizou: o Monitoramento
+ * de Falhas só a envia quando nenhuma falha continua ativa, e qualquer
+ * falha nova volta para DEFEITO.
+ */
+
+namespace atr {
+
+enum class ModoOperacao : std::uint8_t {
+    MANUAL,
+    AUTOMATICO,
+    DEFEITO
+};
+
+enum class ComandoOperador : std::uint8_t {
+    NENHUM,
+    AUTOMATICO, // "c_automatico"
+    MANUAL,     // "c_man"
+    REARME      // "c_rearme"
+};
+
+enum class EstadoLogica : std::uint8_t {
+    MANUAL,
+    AUTOMATICO,
+    DEFEITO,
+    DEFEITO_NORMALIZADO
+};
+
+inline constexpr std::size_t N_ESTADOS  = 4;
+inline constexpr std::size_t N_EVENTOS  = static_cast<std::size_t>(TipoEvento::NORMALIZACAO) + 1;
+inline constexpr std::size_t N_COMANDOS = 4;
+inline constexpr std::size_t N_ENTRADAS = N_EVENTOS + N_COMANDOS;
+
+constexpr std::size_t entrada(TipoEvento ev) { return static_cast<std::size_t>(ev); }
+constexpr std::size_t entrada(ComandoOperador c) { return N_EVENTOS + static_cast<std::size_t>(c); }
+
+constexpr ModoOperacao modo_do_estado(EstadoLogica e) {
+    switch (e) {
+        case EstadoLogica::MANUAL:     return ModoOperacao::MANUAL;
+        case EstadoLogica::AUTOMATICO: return ModoOperacao::AUTOMATICO;
+        default:                       return ModoOperacao::DEFEITO;
+    }
+}
+
+/** @brief Eventos que colocam o caminhão em defeito (os alertas só avisam). */
+constexpr bool evento_de_defeito(TipoEvento ev) {
+    return ev == TipoEvento::DEFEITO_TERMICO || ev == TipoEvento::FALHA_ELETRICA ||
+           ev == TipoEvento::FALHA_HIDRAULICA || ev == TipoEvento::FALHA_SENSOR_TIMEOUT;
+}
+
+/** @brief Regras de transição (fonte da tabela). */
+constexpr EstadoLogica transicao(EstadoLogica e, std::size_t ent) {
+    if (ent < N_EVENTOS) {
+        const auto ev = static_cast<TipoEvento>(ent);
+        if (evento_de_defeito(ev)) return EstadoLogica::DEFEITO;
+        if (ev == TipoEvento::NORMALIZACAO && e == EstadoLogica::DEFEITO) {
+            return EstadoLogica::DEFEITO_NORMALIZADO;
+        }
+        return e;
+    }
+
+    switch (static_cast<ComandoOperador>(ent - N_EVENTOS)) {
+        case ComandoOperador::AUTOMATICO:
+            return e == EstadoLogica::MANUAL ? EstadoLogica::AUTOMATICO : e;
+        case ComandoOperador::MANUAL:
+            return e == EstadoLogica::AUTOMATICO ? EstadoLogica::MANUAL : e;
+        case ComandoOperador::REARME:
+            // volta sempre em manual: o operador decide quando religar o automático
+            return e == EstadoLogica::DEFEITO_NORMALIZADO ? EstadoLogica::MANUAL : e;
+        default:
+            return e;
+    }
+}
+
+namespace detalhe {
+
+template <std::size_t... I>
+constexpr std::array<EstadoLogica, sizeof...(I)> gerar_tabela(std::index_sequence<I...>) {
+    return {{transicao(static_cast<EstadoLogica>(I / N_ENTRADAS), I % N_ENTRADAS)...}};
+}
+
+} // namespace detalhe
+
+inline constexpr std::array<EstadoLogica, N_ESTADOS * N_ENTRADAS> TABELA_TRANSICOES =
+    detalhe::gerar_tabela(std::make_index_sequence<N_ESTADOS * N_ENTRADAS>{});
+
+constexpr EstadoLogica proximo_estado(EstadoLogica e, std::size_t ent) {
+    return TABELA_TRANSICOES[static_cast<std::size_t>(e) * N_ENTRADAS + ent];
+}
+
+/** @brief "c_automatico" / "c_man" / "c_rearme" -> comando; false se desconhecido. */
+constexpr bool comando_de_texto(std::string_view txt, ComandoOperador& cmd) {
+    if (txt == "c_automatico") { cmd = ComandoOperador::AUTOMATICO; return true; }
+    if (txt == "c_man")        { cmd = ComandoOperador::MANUAL;     return true; }
+    if (txt == "c_rearme")     { cmd = ComandoOperador::REARME;     return true; }
+    return false;
+}
+
+constexpr const char* nome_modo(ModoOperacao m) {
+    switch (m) {
+        case ModoOperacao::MANUAL:     return "manual";
+        case ModoOperacao::AUTOMATICO: return "automatico";
+        default:                       return "defeito";
+    }
+}
+
+constexpr bool modo_de_texto(std::string_view txt, ModoOperacao& modo) {
+    if (txt == "manual")     { modo = ModoOperacao::MANUAL;     return true; }
+    if (txt == "automatico") { modo = ModoOperacao::AUTOMATICO; return true; }
+    if (txt == "defeito")    { modo = ModoOperacao::DEFEITO;    return true; }
+    return false;
+}
+
+class MaquinaEstados {
+public:
+    EstadoLogica estado() const { return m_estado; }
+    ModoOperacao modo() const { return modo_do_estado(m_estado); }
+
+    /** @return true se o modo publicado mudou. */
+    bool aplicar(TipoEvento ev) { return avancar(entrada(ev)); }
+    bool aplicar(ComandoOperador c) { return avancar(entrada(c)); }
+
+private:
+    EstadoLogica m_estado = EstadoLogica::MANUAL;
+
+    bool avancar(std::size_t ent) {
+        const ModoOperacao antes = modo();
+        m_estado = proximo_estado(m_estado, ent);
+        return modo() != antes;
+    }
+};
+
+// =====================================================================
+// Propriedades da tabela (toda combinação estado x entrada)
+// =====================================================================
+namespace propriedades {
+
+constexpr EstadoLogica estado(std::size_t i) { return static_cast<EstadoLogica>(i); }
+
+constexpr bool tabela_igual_as_regras() {
+    for (std::size_t e = 0; e < N_ESTADOS; ++e)
+        for (std::size_t i = 0; i < N_ENTRADAS; ++i)
+            if (proximo_estado(estado(e), i) != transicao(estado(e), i)) return false;
+    return true;
+}
+
+constexpr bool defeito_sempre_vence() {
+    for (std::size_t e = 0; e < N_ESTADOS; ++e)
+        for (std::size_t v = 0; v < N_EVENTOS; ++v)
+            if (evento_de_defeito(static_cast<TipoEvento>(v)) &&
+                proximo_estado(estado(e), v) != EstadoLogica::DEFEITO) return false;
+    return true;
+}
+
+// com a falha ativa, nenhuma entrada tira o caminhão do defeito
+constexpr bool defeito_ativo_nao_sai() {
+    for (std::size_t i = 0; i < N_ENTRADAS; ++i)
+        if (modo_do_estado(proximo_estado(EstadoLogica::DEFEITO, i)) != ModoOperacao::DEFEITO) return false;
+    return true;
+}
+
+// sai do defeito só por rearme, após normalização, e sempre para manual
+constexpr bool saida_do_defeito_so_por_rearme() {
+    for (std::size_t e = 0; e < N_ESTADOS; ++e) {
+        if (modo_do_estado(estado(e)) != ModoOperacao::DEFEITO) continue;
+        for (std::size_t i = 0; i < N_ENTRADAS; ++i) {
+            const EstadoLogica p = proximo_estado(estado(e), i);
+            if (modo_do_estado(p) == ModoOperacao::DEFEITO) continue;
+            if (estado(e) != EstadoLogica::DEFEITO_NORMALIZADO || i != entrada(ComandoOperador::REARME) ||
+                p != EstadoLogica::MANUAL) return false;
+        }
+    }
+    return true;
+}
+
+// o automático só é ligado pelo operador, a partir do manual
+constexpr bool automatico_so_por_comando() {
+    for (std::size_t e = 0; e < N_ESTADOS; ++e)
+        for (std::size_t i = 0; i < N_ENTRADAS; ++i)
+            if (estado(e) != EstadoLogica::AUTOMATICO &&
+                proximo_estado(estado(e), i) == EstadoLogica::AUTOMATICO &&
+                (estado(e) != EstadoLogica::MANUAL || i != entrada(ComandoOperador::AUTOMATICO))) return false;
+    return true;
+}
+
+// NENHUM, os alertas (térmico e preditivo) e ComandoOperador::NENHUM não mudam o estado
+constexpr bool entradas_neutras() {
+    for (std::size_t e = 0; e < N_ESTADOS; ++e)
+        for (std::size_t i : {entrada(TipoEvento::NENHUM), entrada(TipoEvento::ALERTA_TERMICO),
+                              entrada(TipoEvento::ALERTA_PREDITIVO), entrada(ComandoOperador::NENHUM)})
+            if (proximo_estado(estado(e), i) != estado(e)) return false;
+    return true;
+}
+
+// repetir a mesma entrada (evento/comando duplicado) não muda nada
+constexpr bool idempotente() {
+    for (std::size_t e = 0; e < N_ESTADOS; ++e)
+        for (std::size_t i = 0; i < N_ENTRADAS; ++i) {
+            const EstadoLogica p = proximo_estado(estado(e), i);
+            if (proximo_estado(p, i) != p) return false;
+        }
+    return true;
+}
+
+constexpr bool todos_alcancaveis_do_manual() {
+    bool alcancado[N_ESTADOS] = {};
+    alcancado[static_cast<std::size_t>(EstadoLogica::MANUAL)] = true;
+    for (std::size_t passo = 0; passo < N_ESTADOS; ++passo)
+        for (std::size_t e = 0; e < N_ESTADOS; ++e)
+            if (alcancado[e])
+                for (std::size_t i = 0; i < N_ENTRADAS; ++i)
+                    alcancado[static_cast<std::size_t>(proximo_estado(estado(e), i))] = true;
+    for (bool a : alcancado)
+        if (!a) return false;
+    return true;
+}
+
+static_assert(TABELA_TRANSICOES.size() == N_ESTADOS * N_ENTRADAS, "tabela incompleta");
+static_assert(tabela_igual_as_regras(), "tabela gerada difere das regras");
+static_assert(defeito_sempre_vence(), "evento de defeito não levou a DEFEITO");
+static_assert(defeito_ativo_nao_sai(), "saída de DEFEITO com falha ativa");
+static_assert(saida_do_defeito_so_por_rearme(), "saída do defeito sem rearme após normalização");
+static_assert(automatico_so_por_comando(), "AUTOMATICO alcançado sem c_automatico");
+static_assert(entradas_neutras(), "entrada neutra mudou o estado");
+static_assert(idempotente(), "entrada repetida mudou o estado");
+static_assert(todos_alcancaveis_do_manual(), "estado inalcançável");
+
+} // namespace propriedades
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef MARCOS_INICIALIZACAO_H
+#define MARCOS_INICIALIZACAO_H
+
+#include <string>
+
+/**
+ * @file Marcos_Inicializacao.h
+ * @brief Medição do tempo de inicialização do núcleo.
+ *
+ * @objetivo Registrar quanto tempo se passou, desde a subida do
+ * container, até cada marco da inicialização (sessões MQTT prontas,
+ * primeira amostra processada), para medir o impacto de reinícios em
+ * massa após uma queda do broker.
+ *
+ * @mecanismo (Interno)
+ * A origem é, nesta ordem: ATR_T0_CONTAINER (segundos desde a época,
+ * exportado pelo start.sh ao subir o container); o início do próprio
+ * processo (/proc/self/stat); ou a primeira chamada, se nenhum dos dois
+ * estiver disponível. Depois de fixada, a medição usa o relógio
+ * monotônico.
+ */
+
+namespace atr {
+
+/** @brief Fixa a origem (chamar no início do main; é idempotente). */
+void marcar_inicio_processo();
+
+/** @brief Segundos desde a origem. */
+double segundos_desde_inicio();
+
+/** @brief Imprime "[Inicialização] +<s> s: <descricao>". */
+void registrar_marco(const std::string& descricao);
+
+} // namespace atr
+
+#endif
@@ -1,9 +1,15 @@
 #ifndef NOTIFICADOR_EVENTOS_H
 #define NOTIFICADOR_EVENTOS_H
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <condition_variable>
 
+#include "Rastreamento.h"
+
 /**
  * @file NotificadorEventos.h
  * @brief Declaração da classe NotificadorEventos.
@@ -14,6 +20,20 @@
  * instantaneamente sobre a ocorrência de um evento de falha.
  * Define os tipos de eventos que podem ocorrer no sistema.
  * Isso permite que a Lógica de Comando saiba exatamente qual foi a falha.
+ *
+ * Consumidor único: antes havia um só evento pendente, entregue (com
+ * notify_all) a quem acordasse primeiro. Agora os eventos ficam em uma
+ * fila fixa (sem alocação) e cada um é entregue a um único
+ * 'esperar_evento*'. Só a Lógica de Comando espera eventos; as demais
+ * tarefas leem o modo publicado por ela. Um segundo consumidor dividiria
+ * os eventos com ela.
+ *
+ * 'disparar_evento' nunca bloqueia nem descarta. Com a fila cheia, os
+ * disparos seguintes são fundidos por tipo (um por tipo, com o carimbo
+ * mais novo) e entregues depois da fila: primeiro os tipos em ordem do
+ * enum, por último o tipo do disparo mais recente. A máquina de estados
+ * chega ao mesmo modo: repetir um evento não muda nada, e o que decide
+ * entre DEFEITO e a normalização é o último deles. O estouro é relatado.
  */
 
 enum class TipoEvento {
@@ -23,7 +43,8 @@ enum class TipoEvento {
     FALHA_ELETRICA,       // i_falha_eletrica = true
     FALHA_HIDRAULICA,     // i_falha_hidraulica = true
     FALHA_SENSOR_TIMEOUT, // sensores pararam de responder
-    NORMALIZACAO          // sistema voltou ao normal
+    ALERTA_PREDITIVO,     // tendência da temperatura projeta DEFEITO_TERMICO em breve
+    NORMALIZACAO          // sistema voltou ao normal (manter por último: Maquina_Estados.h)
 };
 
 class NotificadorEventos {
@@ -35,19 +56,61 @@ public:
      * @return O tipo do evento que causou o desbloqueio.
      */
     TipoEvento esperar_evento();
+
+    /**
+     * @brief Idem, devolvendo também o carimbo da amostra que causou o
+     * evento (para medir a latência até a reação).
+     */
+    TipoEvento esperar_evento(atr::Carimbo& origem);
+
+    /**
+     * @brief Espera um evento até 'limite' (para quem também tem um ciclo
+     * próprio a cumprir).
+     * @param tempo_ate_falha_s (opcional) tempo previsto até a falha, em
+     * ALERTA_PREDITIVO.
+     * @return false se o limite passou sem evento.
+     */
+    bool esperar_evento_ate(std::chrono::steady_clock::time_point limite,
+                            TipoEvento& tipo, atr::Carimbo& origem,
+                            double* tempo_ate_falha_s = nullptr);
     
     /**
-     * @brief Acorda as threads esperando e informa o tipo do evento.
+     * @brief Acorda a thread esperando e informa o tipo do evento.
+     * Não bloqueia: com a fila cheia, funde por tipo (ver acima).
      * @param tipo O tipo de evento a ser reportado.
+     * @param origem Carimbo de ingresso da leitura que gerou o evento.
+     * @param caminhao ID numérico, só para o trace.
+     * @param tempo_ate_falha_s Previsão (s) que acompanha ALERTA_PREDITIVO.
      */
-    void disparar_evento(TipoEvento tipo);
+    void disparar_evento(TipoEvento tipo, const atr::Carimbo& origem = {}, int caminhao = 0,
+                         double tempo_ate_falha_s = 0.0);
 
 private:
+    struct Pendente {
+        TipoEvento tipo = TipoEvento::NENHUM;
+        atr::Carimbo origem;
+        std::int64_t t_disparo_ns = 0;
+        int caminhao = 0;
+        double tempo_ate_falha_s = 0.0;
+    };
+    static constexpr std::size_t CAPACIDADE = 32; // cheia: funde por tipo, nunca descarta
+    static constexpr std::size_t N_TIPOS = static_cast<std::size_t>(TipoEvento::NORMALIZACAO) + 1;
+
     std::mutex m_mutex;
     std::condition_variable m_cv;
     
-    bool m_evento_ativo;
-    TipoEvento m_tipo_atual;
+    std::array<Pendente, CAPACIDADE> m_fila{};
+    std::size_t m_inicio = 0;
+    std::size_t m_qtd = 0;
+
+    // excedente da fila cheia: um pendente por tipo (bit em m_excedentes)
+    std::array<Pendente, N_TIPOS> m_excedente{};
+    std::uint32_t m_excedentes = 0;
+    TipoEvento m_ultimo_excedente = TipoEvento::NENHUM;
+
+    bool ha_pendente() const { return m_qtd > 0 || m_excedentes != 0; }
+
+    Pendente retirar(std::unique_lock<std::mutex>& lock);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef POLITICAS_ENTREGA_H
+#define POLITICAS_ENTREGA_H
+
+#include "Cliente_MQTT.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file Politicas_Entrega.h
+ * @brief Política de entrega (QoS e enfileiramento) por tópico.
+ *
+ * @objetivo Priorizar o dado mais novo no caminho de controle: telemetria
+ * e setpoints usam QoS 0 e, se o consumidor atrasar, só a mensagem mais
+ * recente de cada tópico fica na fila. Falhas e comandos continuam com
+ * QoS 1 e fila completa.
+ *
+ * @mecanismo (Interno)
+ * A tabela é um RoteadorTopicos de filtros MQTT; vale a regra mais
+ * específica (literal > '+' > '#'). Configure no main, antes de criar as
+ * threads (como o transporte); depois disso a tabela só é lida.
+ *
+ * Regras extras por ambiente (ATR_QOS_POLITICAS), somadas às padrão
+ * (o mesmo filtro substitui a regra padrão):
+ *   "atr/+/sensor/raw=confiavel;atr/+/planner/log=ultimo"
+ */
+
+namespace atr {
+
+enum class PoliticaEntrega {
+    ULTIMO_VALOR,   // QoS 0; na fila, a mensagem nova substitui a antiga do mesmo tópico
+    MELHOR_ESFORCO, // QoS 0; fila normal (ex.: logs)
+    CONFIAVEL       // QoS 1; fila normal (falhas, comandos)
+};
+
+struct RegraEntrega {
+    std::string filtro;
+    PoliticaEntrega politica;
+};
+
+/** @brief Regras padrão do núcleo (telemetria/setpoints, logs, falhas/comandos). */
+std::vector<RegraEntrega> politicas_padrao();
+
+/** @brief Substitui a tabela de políticas (chamar antes de criar as threads). */
+void definir_politicas_entrega(const std::vector<RegraEntrega>& regras);
+
+/**
+ * @brief Lê "filtro=politica;..." (politica: ultimo, melhor_esforco, confiavel)
+ * e acrescenta as regras em 'saida'. Retorna false se alguma for inválida
+ * (política desconhecida ou filtro mal formado, ver RoteadorTopicos::filtro_valido).
+ */
+bool politicas_de_texto(const std::string& texto, std::vector<RegraEntrega>& saida);
+
+/** @brief Política do tópico (ou filtro). Sem regra: CONFIAVEL. */
+PoliticaEntrega politica_do_topico(std::string_view topico);
+
+int qos_da_politica(PoliticaEntrega politica);
+int qos_do_topico(std::string_view topico);
+
+/** @brief Assinatura do filtro com o QoS da sua política. */
+Assinatura assinatura(const std::string& filtro);
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef POOL_MENSAGENS_H
+#define POOL_MENSAGENS_H
+
+#include "Cliente_MQTT.h"
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file Pool_Mensagens.h
+ * @brief Declaração da classe PoolMensagens.
+ *
+ * @objetivo Reaproveitar os objetos MensagemMQTT (e a capacidade já
+ * reservada de suas strings de tópico/payload) entre mensagens, para que
+ * o caminho transporte -> fila -> tarefa não use o heap em regime.
+ *
+ * @mecanismo (Interno)
+ * adquirir() devolve um shared_ptr cujo deleter não destrói a mensagem:
+ * ela volta para a lista de livres do pool. O bloco de controle do
+ * shared_ptr também sai de uma lista de blocos reciclados. Só há
+ * alocação no aquecimento, enquanto o número de mensagens em voo cresce.
+ *
+ * A mensagem só pode voltar ao pool quando a última referência morre,
+ * então o estado interno é compartilhado e sobrevive ao próprio pool.
+ */
+
+namespace atr {
+
+class PoolMensagens {
+public:
+    /**
+     * @param reserva_payload Capacidade reservada no payload de cada
+     * mensagem nova (evita realocar nas primeiras mensagens).
+     */
+    explicit PoolMensagens(std::size_t reserva_payload = 512);
+
+    /** @brief Mensagem livre (tópico/payload com conteúdo antigo: sobrescreva). */
+    std::shared_ptr<MensagemMQTT> adquirir();
+
+    /** @brief Total de mensagens já criadas (cresce só no aquecimento). */
+    std::size_t criadas() const;
+
+    struct Estado; // interno ao .cpp
+
+private:
+    std::shared_ptr<Estado> m_estado;
+};
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef PREVISAO_TERMICA_H
+#define PREVISAO_TERMICA_H
+
+#include "Config_Falhas.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @file Previsao_Termica.h
+ * @brief Declaração da classe PrevisaoTermica.
+ *
+ * @objetivo Antecipar o defeito térmico: em vez de esperar a temperatura
+ * passar de falha_on (120 °C), estimar a tendência e prever em quanto
+ * tempo ela chega lá, para emitir um alerta preditivo com antecedência.
+ *
+ * @mecanismo (Interno)
+ * Por caminhão, a cada amostra (O(1), sem alocação):
+ * - nível: média exponencial (EWMA) com constante de tempo tau_nivel_s,
+ *   corrigida pela tendência (suavização de Holt), para não atrasar em rampa;
+ * - tendência (°C/s): EWMA da inclinação, com constante tau_tendencia_s;
+ * - variância: EWMA do quadrado do erro de previsão de um passo.
+ * As constantes valem em tempo (alfa = dt / (tau + dt)), então as
+ * amostras podem chegar em intervalos irregulares.
+ *
+ * Tempo até a falha = (limite - (nível + sigmas * desvio)) / tendência,
+ * se a tendência for positiva e significativa; infinito caso contrário.
+ * Usar a banda superior (nível + sigmas * desvio) torna a previsão
+ * conservadora quando a leitura é ruidosa.
+ *
+ * Estado em SoA (um vetor por grandeza, um índice por caminhão) e passo
+ * só com aritmética e seleções (sem exp/log, sem desvios por amostra).
+ *
+ * Escopo atual: cada Monitoramento de Falhas atende um caminhão e tem a
+ * própria instância, com um índice só. Não há processamento da frota em
+ * lote: sem um chamador que receba as amostras da frota inteira, o lote
+ * foi retirado e nenhum custo por amostra foi medido.
+ */
+
+namespace atr {
+
+struct ConfigPrevisao {
+    double limite          = FaultConfig{}.falha_on; // °C
+    double tau_nivel_s     = 2.0;   // suavização do nível
+    double tau_tendencia_s = 10.0;  // suavização da inclinação
+    double sigmas          = 2.0;   // banda de ruído somada ao nível
+    double inclinacao_min  = 0.01;  // °C/s: abaixo disso, sem previsão
+    double horizonte_s     = 60.0;  // alerta se a falha prevista vier antes disso
+    std::uint32_t min_amostras = 20; // aquecimento do filtro
+};
+
+class PrevisaoTermica {
+public:
+    static constexpr double SEM_PREVISAO = std::numeric_limits<double>::infinity();
+
+    explicit PrevisaoTermica(const ConfigPrevisao& cfg = {});
+
+    /** @brief Reserva o estado de mais um caminhão. @return índice. */
+    std::size_t adicionar();
+    std::size_t tamanho() const { return m_nivel.size(); }
+
+    /**
+     * @brief Processa uma amostra do caminhão 'i'.
+     * @param temp Temperatura (°C).
+     * @param t_s  Instante da amostra (s, relógio monotônico).
+     * @return Tempo previsto até a falha (s); SEM_PREVISAO se não há tendência de alta.
+     */
+    double atualizar(std::size_t i, double temp, double t_s);
+
+    /**
+     * @brief Histerese do alerta: true quando a previsão cai abaixo do
+     * horizonte (uma vez); volta a armar quando passa de 2x o horizonte.
+     */
+    bool novo_alerta(std::size_t i, double tempo_ate_falha);
+
+    double nivel(std::size_t i) const { return m_nivel[i]; }
+    double tendencia(std::size_t i) const { return m_tendencia[i]; }
+    double desvio(std::size_t i) const;
+
+    const ConfigPrevisao& config() const { return m_cfg; }
+
+private:
+    ConfigPrevisao m_cfg;
+
+    std::vector<double> m_nivel;
+    std::vector<double> m_tendencia; // °C/s
+    std::vector<double> m_variancia;
+    std::vector<double> m_t_ultima;
+    std::vector<std::uint32_t> m_amostras;
+    std::vector<std::uint8_t> m_alertado;
+};
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RASTREAMENTO_H
+#define RASTREAMENTO_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @file Rastreamento.h
+ * @brief Carimbo de ingresso das amostras e exportador de trace.
+ *
+ * @objetivo Saber a idade de cada dado ao longo do grafo de tarefas
+ * (MQTT -> Tratamento -> Buffer -> Planejamento -> setpoints; MQTT ->
+ * Monitoramento -> NotificadorEventos -> assinantes).
+ *
+ * @mecanismo (Interno)
+ * - Carimbo: sequência + instante monotônico (steady_clock, ns) da
+ *   chegada via MQTT. É copiado junto com o dado (PosicaoData,
+ *   setpoints, eventos); cada etapa mede a partir dele.
+ * - ExportadorTrace: com ATR_TRACE_ARQUIVO definido, grava intervalos
+ *   (uma etapa de uma amostra) no formato Chrome Trace Event (JSON),
+ *   que abre no chrome://tracing ou no Perfetto. Os eventos vão para
+ *   um vetor sob mutex e uma thread grava o arquivo a cada 0,5 s; o
+ *   arquivo é válido mesmo se o processo for morto (o formato aceita a
+ *   lista sem o ']' final). Desligado, o custo é uma leitura atômica.
+ */
+
+namespace atr {
+
+/** @brief Instante monotônico em ns. */
+inline std::int64_t em_ns(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+inline std::int64_t agora_ns() {
+    return em_ns(std::chrono::steady_clock::now());
+}
+
+struct Carimbo {
+    std::uint64_t seq = 0;          // sequência atribuída no ingresso (por fonte)
+    std::int64_t t_ingresso_ns = 0; // chegada via MQTT (monotônico); 0 = sem carimbo
+
+    bool valido() const { return t_ingresso_ns != 0; }
+};
+
+class ExportadorTrace {
+public:
+    /** @brief Liga a exportação se ATR_TRACE_ARQUIVO estiver definido (chamar no main). */
+    static void iniciar_do_ambiente();
+
+    static bool ativo();
+
+    /**
+     * @brief Registra a etapa 'nome' de uma amostra: [inicio_ns, fim_ns].
+     * @param nome     Literal estático (ex.: "sensor: mqtt->buffer").
+     * @param caminhao Vira o "processo" no visualizador.
+     */
+    static void intervalo(const char* nome, int caminhao, std::int64_t inicio_ns,
+                          std::int64_t fim_ns, std::uint64_t seq);
+};
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef ROTEADOR_TOPICOS_H
+#define ROTEADOR_TOPICOS_H
+
+#include "Cliente_MQTT.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file Roteador_Topicos.h
+ * @brief Declaração da classe RoteadorTopicos.
+ *
+ * @objetivo Resolver um tópico MQTT recebido para um tratador já
+ * vinculado (e para o índice do caminhão a que ele pertence) sem
+ * comparar strings em sequência nem copiar o tópico.
+ *
+ * @mecanismo (Interno)
+ * Os filtros são internados uma única vez em uma trie por nível
+ * ('/'), com filhos ordenados e ramos dedicados para '+' e '#'.
+ * A resolução percorre o tópico com std::string_view, sem alocação
+ * por mensagem. Em cada nível, a busca binária nos filhos custa
+ * O(log filhos), então milhares de caminhões com rotas literais não
+ * pesam na resolução.
+ *
+ * Custo: O(tamanho do tópico) quando, em cada nível, só um ramo da
+ * trie casa (só rotas literais, ou curingas em níveis sem literal).
+ * Com filtros sobrepostos ("atr/1/act" e "atr/+/act"), a busca desce
+ * pelo ramo literal e pelo '+' em cada nível e volta atrás. No pior
+ * caso visita todos os nós que casam com o tópico (cada nó uma vez
+ * só), até 2^níveis com curingas em todos os níveis. Nos tópicos
+ * atr/<id>/... são no máximo dois ramos por nível.
+ *
+ * Não é thread-safe para escrita: registre as rotas antes de começar
+ * a despachar, ou proteja com um mutex externo (como o BrokerLocal faz).
+ */
+
+namespace atr {
+
+class RoteadorTopicos {
+public:
+    using Tratador = std::function<void(const MensagemMQTT& msg, int indice)>;
+
+    static constexpr std::uint32_t SEM_ROTA = UINT32_MAX;
+
+    RoteadorTopicos();
+
+    /**
+     * @brief Filtro MQTT bem formado: não vazio, '+' e '#' ocupando um
+     * nível inteiro e '#' só no último ("a/#/b" e "foo+" são inválidos).
+     * É a regra de internar()/registrar() e do BrokerLocal.
+     */
+    static bool filtro_valido(std::string_view filtro);
+
+    /**
+     * @brief Interna o filtro e devolve seu id estável (mesmo filtro, mesmo id).
+     * @return SEM_ROTA se o filtro for inválido (ver filtro_valido()).
+     */
+    std::uint32_t internar(std::string_view filtro);
+
+    /**
+     * @brief Interna o filtro e vincula o tratador e o índice do caminhão.
+     * @return id da rota, ou SEM_ROTA se o filtro for inválido.
+     */
+    std::uint32_t registrar(std::string_view filtro, Tratador tratador, int indice = 0);
+
+    /**
+     * @brief Desativa a rota do filtro (o id continua reservado).
+     */
+    void remover(std::string_view filtro);
+
+    /**
+     * @brief Rota mais específica para o tópico (literal > '+' > '#').
+     * @return id da rota ou SEM_ROTA.
+     */
+    std::uint32_t resolver(std::string_view topico) const;
+
+    /**
+     * @brief Chama f(id) para cada filtro ativo que casa com o tópico.
+     */
+    template <typename F>
+    void para_cada(std::string_view topico, F&& f) const {
+        using Fn = std::remove_reference_t<F>;
+        visitar_em(0, topico, true,
+                   [](void* ctx, std::uint32_t id) { (*static_cast<Fn*>(ctx))(id); },
+                   const_cast<void*>(static_cast<const void*>(&f)));
+    }
+
+    /**
+     * @brief Resolve o tópico da mensagem e chama o tratador vinculado.
+     *
+     * Só a rota mais específica é considerada. Se ela não tiver tratador
+     * (registrada com nullptr), a mensagem é engolida: não há recuo para
+     * um '+' ou '#' menos específico que também case. Isso é contrato: o
+     * AgregadorFrota registra rotas literais sem tratador para descartar
+     * mensagens atrasadas de caminhões removidos (CAMINHAO_REMOVIDO).
+     * @return false se nenhuma rota casou ou se a rota não tem tratador.
+     */
+    bool despachar(const MensagemMQTT& msg) const;
+
+    const std::string& filtro(std::uint32_t id) const { return m_rotas[id].filtro; }
+    int indice(std::uint32_t id) const { return m_rotas[id].indice; }
+    std::size_t tamanho() const { return m_rotas.size(); }
+
+private:
+    struct Filho {
+        std::string nivel;
+        std::uint32_t no;
+    };
+
+    struct No {
+        std::vector<Filho> filhos;          // ordenados por 'nivel'
+        std::uint32_t mais      = SEM_ROTA; // nó filho do curinga '+'
+        std::uint32_t rota      = SEM_ROTA; // filtro que termina neste nó
+        std::uint32_t cerquilha = SEM_ROTA; // filtro "<prefixo>/#"
+    };
+
+    struct Rota {
+        std::string filtro;
+        Tratador tratador;
+        int indice = 0;
+        bool ativa = false;
+    };
+
+    std::vector<No> m_nos; // m_nos[0] é a raiz
+    std::vector<Rota> m_rotas;
+
+    std::uint32_t filho_literal(std::uint32_t no, std::string_view nivel) const;
+    std::uint32_t criar_filho(std::uint32_t no, std::string_view nivel);
+    std::uint32_t* slot_do_filtro(std::string_view filtro, bool criar);
+
+    std::uint32_t resolver_em(std::uint32_t no, std::string_view resto, bool primeiro) const;
+    void visitar_em(std::uint32_t no, std::string_view resto, bool primeiro,
+                    void (*f)(void*, std::uint32_t), void* ctx) const;
+
+    bool rota_ativa(std::uint32_t id) const {
+        return id != SEM_ROTA && m_rotas[id].ativa;
+    }
+};
+
+} // namespace atr
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef SIMULADOR_MINA_H
+#define SIMULADOR_MINA_H
+
+#include "Cliente_MQTT.h"
+#include "Roteador_Topicos.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file Simulador_Mina.h
+ * @brief Declaração da classe SimuladorMina.
+ *
+ * @objetivo Versão nativa e sem interface do 'simulator_view.py', para
+ * gerar carga de sensores de frotas grandes (milhares de caminhões) e
+ * mais rápido que o tempo real. Usa o mesmo protocolo MQTT:
+ *  - publica atr/<id>/sensor/raw e atr/<id>/sim/log;
+ *  - recebe atr/<id>/act, atr/<id>/sim/cmd, atr/sim/spawn e atr/sim/remove.
+ *
+ * @mecanismo (Interno)
+ * - Estado da frota em SoA (um vetor por grandeza), integrado em blocos
+ *   por um conjunto fixo de threads a cada passo.
+ * - As mensagens recebidas são apenas enfileiradas pelo callback do
+ *   transporte; o passo as aplica antes de integrar, na thread do
+ *   simulador. Assim, a integração paralela nunca disputa o estado
+ *   com o transporte, e spawn/remove podem reorganizar os vetores.
+ * - A dinâmica (atrito, limites, temperatura, publicação por mudança de
+ *   célula) é a mesma do simulador Python.
+ */
+
+namespace atr {
+
+struct ConfigSimulador {
+    double hz = 20.0;                // passos por segundo simulado (DT = 1/hz)
+    std::size_t threads = 0;         // 0 = std::thread::hardware_concurrency()
+    double fator_tempo = 1.0;        // 1 = tempo real, 10 = 10x mais rápido, 0 = sem espera
+    bool publicar_todo_passo = false; // false: como o Python (só ao mudar de célula)
+};
+
+class SimuladorMina {
+public:
+    SimuladorMina(ClienteMQTT& cliente, const ConfigSimulador& cfg);
+    ~SimuladorMina();
+
+    SimuladorMina(const SimuladorMina&) = delete;
+    SimuladorMina& operator=(const SimuladorMina&) = delete;
+
+    /**
+     * @brief Conecta (com retentativas) e assina os tópicos de atuadores e
+     * comandos. Chamar antes de adicionar caminhões.
+     */
+    void iniciar();
+
+    /**
+     * @brief Cria um caminhão (mesmo efeito de atr/sim/spawn). Thread do simulador.
+     * @return false se o id já existe ou não serve como nível de tópico
+     * (vazio, ou com '/', '+' ou '#').
+     */
+    bool adicionar_caminhao(const std::string& id);
+
+    /** @brief Remove um caminhão (mesmo efeito de atr/sim/remove). Thread do simulador. */
+    bool remover_caminhao(const std::string& id);
+
+    /** @brief Aplica as mensagens pendentes e integra um passo de toda a frota. */
+    void passo();
+
+    /**
+     * @brief Roda passos até 'parar' ficar true (ou 'duracao_s' de tempo
+     * simulado, se > 0), respeitando cfg.fator_tempo.
+     */
+    void executar(const std::atomic<bool>& parar, double duracao_s = 0.0);
+
+    // leitura segura de outras threads (relatórios)
+    std::size_t caminhoes() const { return m_caminhoes.load(std::memory_order_relaxed); }
+    std::uint64_t passos() const { return m_passos.load(std::memory_order_relaxed); }
+    std::uint64_t descartadas() const { return m_descartadas.load(std::memory_order_relaxed); }
+    double dt() const { return m_dt; }
+
+private:
+    ClienteMQTT& m_cli;
+    ConfigSimulador m_cfg;
+    double m_dt;
+    std::atomic<std::uint64_t> m_passos{0};
+    std::atomic<std::size_t> m_caminhoes{0};
+    std::atomic<std::uint64_t> m_descartadas{0}; // publicações perdidas (broker fora)
+
+    // ---- estado da frota (SoA) ----
+    std::vector<std::string> m_id;
+    std::vector<std::string> m_topico_sensor;
+    std::vector<std::string> m_topico_log;
+    std::vector<std::uint8_t> m_qos_sensor, m_qos_log; // da política de cada tópico
+    std::vector<double> m_x, m_y, m_ang, m_v, m_temp;
+    std::vector<double> m_o_acel, m_o_dir;
+    std::vector<double> m_sigma_pos, m_sigma_ang, m_sigma_temp;
+    std::vector<std::uint8_t> m_f_eletrica, m_f_hidraulica;
+    std::vector<std::int64_t> m_cel_x, m_cel_y;
+    std::vector<std::uint64_t> m_seq;
+
+    // ---- entrada: mensagens recebidas, aplicadas no início do passo ----
+    std::mutex m_mtx_entrada;
+    std::vector<MensagemPtr> m_entrada;
+    std::vector<MensagemPtr> m_processando;
+    RoteadorTopicos m_rotas; // atr/<id>/act e atr/<id>/sim/cmd -> índice
+
+    // ---- integração paralela ----
+    class Executor;
+    std::unique_ptr<Executor> m_exec;
+
+    void receber(const MensagemPtr& msg);
+    void aplicar_entrada();
+    void aplicar_atuador(int indice, const std::string& payload);
+    void aplicar_comando(int indice, const std::string& payload);
+    void tratar_spawn(const std::string& payload);
+    void tratar_remove(const std::string& payload);
+    void registrar_rotas(std::size_t indice);
+    int indice_de(const std::string& id) const; // -1 se não existe
+
+    void integrar_bloco(std::size_t ini, std::size_t fim, std::size_t trabalhador);
+    void publicar_sensor(std::size_t i, std::size_t trabalhador);
+    void publicar_log(std::size_t i, const std::string& texto);
+    void publicar(const std::string& topico, const std::string& payload, int qos);
+};
+
+} // namespace atr
+
+#endif
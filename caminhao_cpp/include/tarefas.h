@@ -4,16 +4,19 @@
 // As classes estão no namespace global (pelos seus headers atuais)
 class BufferCircular;
 class NotificadorEventos;
+class HistoricoTrajetoria;
 
 namespace atr {
 
 // Espelha os tipos globais dentro de atr para não duplicar declarações
 using ::BufferCircular;
 using ::NotificadorEventos;
+using ::HistoricoTrajetoria;
 
 /**
  * @brief Thread do Tratamento de Sensores
- *  - Assina MQTT (atr/+/sensor/raw)
+ *  - Assina MQTT (atr/<id>/sensor/raw de cada caminhão vinculado)
+ *  - Roteia pelo tópico (RoteadorTopicos) até o caminhão de destino
  *  - Filtra (média móvel) e publica no(s) buffer(es)
  */
 void tarefa_tratamento_sensores_run(const std::string& broker = "localhost");
@@ -26,8 +29,13 @@ void tarefa_logica_comando(int id, BufferCircular& buffer, NotificadorEventos& n
 void tarefa_coletor_dados(int id, BufferCircular& buffer, NotificadorEventos& notificador);
 void tarefa_controle_navegacao(int id, BufferCircular& buffer, NotificadorEventos& notificador);
 void tarefa_planejamento_rota(int id, BufferCircular& buffer);
-// vincula o buffer e o id local para a thread de sensores (chamar no main antes de criar a thread)
-void tratamento_sensores(BufferCircular* buffer_ptr, int caminhao_id);
+// atende pedidos MQTT de trajetória (atr/<id>/historico/consulta -> .../resposta)
+void tarefa_consulta_historico(int id, const HistoricoTrajetoria& historico);
+// vincula o buffer e o id local para a thread de sensores (chamar no main antes de criar a thread;
+// pode ser chamada mais de uma vez para atender vários caminhões no mesmo processo)
+// 'historico' (opcional) recebe as mesmas posições para os agregados de 1 s / 10 s
+void tratamento_sensores(BufferCircular* buffer_ptr, int caminhao_id,
+                         HistoricoTrajetoria* historico = nullptr);
 
 
 } // namespace atr
@@ -0,0 +1,127 @@
+/**
+ * @file main_simulador.cpp
+ * @brief Ponto de entrada do simulador de mina nativo (sem interface).
+ *
+ * Substitui o 'simulator_view.py' em testes de carga: mesma dinâmica e
+ * mesmos tópicos, mas com a frota inteira em um processo e um cliente.
+ *
+ * Uso:
+ *   simulador_mina [--caminhoes N] [--primeiro ID] [--hz HZ] [--threads T]
+ *                  [--fator F] [--duracao S] [--publicar-sempre]
+ *                  [--broker HOST] [--porta P] [--transporte paho|local]
+ *
+ *   --fator 1 = tempo real (padrão), 10 = 10x mais rápido, 0 = sem espera.
+ *   --duracao em segundos simulados (0 = até Ctrl+C).
+ */
+
+#include "Cliente_MQTT.h"
+#include "Simulador_Mina.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> g_parar{false};
+
+void ao_sinal(int) { g_parar.store(true); }
+
+void uso(const char* prog) {
+    std::cerr << "Uso: " << prog
+              << " [--caminhoes N] [--primeiro ID] [--hz HZ] [--threads T] [--fator F]"
+                 " [--duracao S] [--publicar-sempre] [--broker HOST] [--porta P]"
+                 " [--transporte paho|local]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    atr::ConfigSimulador cfg;
+    int caminhoes = 1;
+    int primeiro  = 1;
+    double duracao_s = 0.0;
+    std::string host = "localhost";
+    int porta = 1883;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool tem_valor = (i + 1 < argc);
+        try {
+            if (arg == "--caminhoes" && tem_valor)      caminhoes = std::stoi(argv[++i]);
+            else if (arg == "--primeiro" && tem_valor)  primeiro = std::stoi(argv[++i]);
+            else if (arg == "--hz" && tem_valor)        cfg.hz = std::stod(argv[++i]);
+            else if (arg == "--threads" && tem_valor)   cfg.threads = std::stoul(argv[++i]);
+            else if (arg == "--fator" && tem_valor)     cfg.fator_tempo = std::stod(argv[++i]);
+            else if (arg == "--duracao" && tem_valor)   duracao_s = std::stod(argv[++i]);
+            else if (arg == "--publicar-sempre")        cfg.publicar_todo_passo = true;
+            else if (arg == "--broker" && tem_valor)    host = argv[++i];
+            else if (arg == "--porta" && tem_valor)     porta = std::stoi(argv[++i]);
+            else if (arg == "--transporte" && tem_valor) {
+                atr::TransporteMQTT t;
+                if (!atr::transporte_de_texto(argv[++i], t)) {
+                    uso(argv[0]);
+                    return 1;
+                }
+                atr::definir_transporte_mqtt(t);
+            } else {
+                uso(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Simulador] valor inválido para " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, ao_sinal);
+    std::signal(SIGTERM, ao_sinal);
+
+    const std::string client_id =
+        "sim_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    auto cliente = atr::criar_cliente_mqtt(atr::uri_broker(host, porta), client_id);
+
+    // conecta com retentativas (não falha se o broker ainda está subindo)
+    atr::SimuladorMina sim(*cliente, cfg);
+    sim.iniciar();
+    for (int k = 0; k < caminhoes; ++k) {
+        sim.adicionar_caminhao(std::to_string(primeiro + k));
+    }
+
+    // relatório a cada ~1 s de relógio: passos/s e caminhões·passo/s
+    std::thread relatorio([&sim] {
+        using Clock = std::chrono::steady_clock;
+        auto t_ant = Clock::now();
+        std::uint64_t p_ant = 0;
+        while (!g_parar.load()) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const auto t = Clock::now();
+            const std::uint64_t p = sim.passos();
+            const double seg = std::chrono::duration<double>(t - t_ant).count();
+            const double passos_s = static_cast<double>(p - p_ant) / seg;
+            std::cout << "[Simulador] " << sim.caminhoes() << " caminhões, "
+                      << passos_s << " passos/s (" << passos_s * sim.dt() << "x tempo real), "
+                      << passos_s * static_cast<double>(sim.caminhoes()) << " caminhões·passo/s, "
+                      << sim.descartadas() << " publicações descartadas\n";
+            t_ant = t;
+            p_ant = p;
+        }
+    });
+
+    sim.executar(g_parar, duracao_s);
+    g_parar.store(true);
+    relatorio.join();
+
+    std::cout << "[Simulador] " << sim.passos() << " passos ("
+              << static_cast<double>(sim.passos()) * sim.dt() << " s simulados).\n";
+
+    try {
+        cliente->desconectar();
+    } catch (...) {
+    }
+    return 0;
+}
@@ -0,0 +1,403 @@
+/**
+ * @file Agregador_Frota.cpp
+ * @brief Implementação da classe AgregadorFrota.
+ *
+ * @objetivo Consumir a telemetria e o modo de todos os caminhões,
+ * atualizar a tabela da frota e publicar, a cada quadro, só o que mudou.
+ *
+ * @entradas (Inputs)
+ * 1. atr/+/sensor/raw, atr/+/act, atr/sim/spawn, atr/sim/remove
+ *
+ * @saidas (Outputs)
+ * 1. atr/frota/delta (QoS 1), atr/frota/estado (QoS 1, retido)
+ */
+#include "Agregador_Frota.h"
+#include "Config_Falhas.h"
+#include "Json_Plano.h"
+#include "Maquina_Estados.h"
+#include "Politicas_Entrega.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using json = nlohmann::json;
+
+namespace atr {
+
+namespace {
+
+const std::string TOPICO_DELTA  = "atr/frota/delta";
+const std::string TOPICO_ESTADO = "atr/frota/estado";
+
+// rota curinga: caminhão ainda sem rotas literais
+constexpr int CAMINHAO_NOVO = -2;
+// rota literal de um caminhão removido: mensagens atrasadas são descartadas
+constexpr int CAMINHAO_REMOVIDO = -3;
+
+// limiares do Monitoramento de Falhas (falha_on / falha_off, com histerese)
+const FaultConfig LIMIARES;
+
+double agora_epoch() {
+    using namespace std::chrono;
+    return duration<double>(system_clock::now().time_since_epoch()).count();
+}
+
+// "atr/<id>/..." -> "<id>"
+std::string_view id_do_topico(std::string_view topico) {
+    const std::size_t a = topico.find('/');
+    if (a == std::string_view::npos) return {};
+    const std::size_t b = topico.find('/', a + 1);
+    return topico.substr(a + 1, (b == std::string_view::npos ? topico.size() : b) - a - 1);
+}
+
+// id que pode virar um nível de tópico literal (atr/<id>/...)
+bool id_valido(std::string_view id) {
+    return !id.empty() && id.find_first_of("/+#") == std::string_view::npos;
+}
+
+// "truck_id": "<id>" | <número> | [...] -> f(id) para cada um
+template <typename F>
+void para_cada_truck_id(const json& data, F&& f) {
+    auto um = [&](const json& tid) { f(tid.is_string() ? tid.get<std::string>() : tid.dump()); };
+    const json& tids = data["truck_id"];
+    if (tids.is_array()) {
+        for (const json& tid : tids) um(tid);
+    } else {
+        um(tids);
+    }
+}
+
+} // namespace
+
+AgregadorFrota::AgregadorFrota(ClienteMQTT& cliente, const ConfigAgregador& cfg)
+    : m_cli(cliente),
+      m_cfg(cfg)
+{
+    m_rotas.registrar("atr/+/sensor/raw", nullptr, CAMINHAO_NOVO);
+    m_rotas.registrar("atr/+/act", nullptr, CAMINHAO_NOVO);
+    m_rotas.registrar("atr/sim/spawn",
+                      [this](const MensagemMQTT& m, int) { tratar_spawn(m.payload); }, -1);
+    m_rotas.registrar("atr/sim/remove",
+                      [this](const MensagemMQTT& m, int) { tratar_remove(m.payload); }, -1);
+    m_saida.reserve(4096);
+}
+
+void AgregadorFrota::iniciar()
+{
+    m_cli.iniciar_consumo();
+    m_cli.conectar_sessao({assinatura("atr/+/sensor/raw"), assinatura("atr/+/act"),
+                           assinatura("atr/sim/spawn"), assinatura("atr/sim/remove")},
+                          "Agregador");
+}
+
+// ---------------------------------------------------------------------
+// Tabela da frota
+// ---------------------------------------------------------------------
+
+void AgregadorFrota::registrar_rotas(std::size_t indice)
+{
+    const int i = static_cast<int>(indice);
+    const std::string& id = m_id[indice];
+    m_rotas.registrar("atr/" + id + "/sensor/raw",
+                      [this](const MensagemMQTT& m, int idx) { amostra_sensor(idx, m); }, i);
+    m_rotas.registrar("atr/" + id + "/act",
+                      [this](const MensagemMQTT& m, int idx) { atuadores(idx, m); }, i);
+}
+
+int AgregadorFrota::indice_de(std::string_view id)
+{
+    // a rota literal do caminhão já guarda o índice
+    const std::uint32_t rota = m_rotas.resolver("atr/" + std::string(id) + "/sensor/raw");
+    if (rota == RoteadorTopicos::SEM_ROTA) return -1;
+    const int i = m_rotas.indice(rota);
+    return i >= 0 ? i : -1;
+}
+
+void AgregadorFrota::marcar_removido(const std::string& id)
+{
+    // rotas literais sem tratador têm prioridade sobre o curinga e o
+    // despachar() as engole (contrato do RoteadorTopicos): o que ainda
+    // estiver a caminho para este id não recria o caminhão
+    m_rotas.registrar("atr/" + id + "/sensor/raw", nullptr, CAMINHAO_REMOVIDO);
+    m_rotas.registrar("atr/" + id + "/act", nullptr, CAMINHAO_REMOVIDO);
+}
+
+int AgregadorFrota::indice_do_topico(const std::string& topico)
+{
+    const std::string_view id = id_do_topico(topico);
+    if (!id_valido(id)) return -1;
+    const int existente = indice_de(id);
+    if (existente >= 0) return existente;
+
+    m_id.emplace_back(id);
+    m_x.push_back(0.0); m_y.push_back(0.0); m_ang.push_back(0.0); m_temp.push_back(0.0);
+    m_modo.push_back(MODO_DESCONHECIDO);
+    m_falhas.push_back(SEM_DADOS);
+    m_t_ultima.push_back(Clock::time_point{});
+    m_env_x.push_back(0.0); m_env_y.push_back(0.0); m_env_ang.push_back(0.0); m_env_temp.push_back(0.0);
+    m_env_modo.push_back(MODO_DESCONHECIDO);
+    m_env_falhas.push_back(SEM_DADOS);
+    m_novo.push_back(1);
+
+    const std::size_t i = m_id.size() - 1;
+    registrar_rotas(i);
+    m_caminhoes.store(m_id.size(), std::memory_order_relaxed);
+    // um id removido e que voltou não fica na lista de removidos do quadro
+    m_removidos.erase(std::remove(m_removidos.begin(), m_removidos.end(), m_id[i]), m_removidos.end());
+    return static_cast<int>(i);
+}
+
+void AgregadorFrota::remover(std::size_t i)
+{
+    const std::size_t ult = m_id.size() - 1;
+    marcar_removido(m_id[i]);
+    if (!m_novo[i]) m_removidos.push_back(m_id[i]); // quem nunca foi enviado sai sem aviso
+
+    // remove por troca com o último: O(1), mantém os vetores densos
+    auto trocar = [&](auto& v) {
+        if (i != ult) v[i] = std::move(v[ult]);
+        v.pop_back();
+    };
+    trocar(m_id);
+    trocar(m_x); trocar(m_y); trocar(m_ang); trocar(m_temp);
+    trocar(m_modo); trocar(m_falhas); trocar(m_t_ultima);
+    trocar(m_env_x); trocar(m_env_y); trocar(m_env_ang); trocar(m_env_temp);
+    trocar(m_env_modo); trocar(m_env_falhas); trocar(m_novo);
+
+    m_caminhoes.store(m_id.size(), std::memory_order_relaxed);
+    if (i != ult) registrar_rotas(i); // o antigo último mudou de índice
+}
+
+// ---------------------------------------------------------------------
+// Entrada
+// ---------------------------------------------------------------------
+
+void AgregadorFrota::amostra_sensor(int indice, const MensagemMQTT& msg)
+{
+    const std::size_t i = static_cast<std::size_t>(indice);
+    const std::string& p = msg.payload;
+
+    double v;
+    if (json_numero(p, "i_posicao_x", v)) m_x[i] = v;
+    if (json_numero(p, "i_posicao_y", v)) m_y[i] = v;
+    if (json_numero(p, "i_angulo_x", v))  m_ang[i] = v;
+
+    std::uint8_t f = m_falhas[i] & FALHA_TERMICA; // térmica tem histerese
+    if (json_numero(p, "i_temperatura", v)) {
+        m_temp[i] = v;
+        if (v > LIMIARES.falha_on) f |= FALHA_TERMICA;
+        else if (v < LIMIARES.falha_off) f &= static_cast<std::uint8_t>(~FALHA_TERMICA);
+    }
+    bool b = false;
+    if (json_booleano(p, "i_falha_eletrica", b) && b)   f |= FALHA_ELETRICA;
+    if (json_booleano(p, "i_falha_hidraulica", b) && b) f |= FALHA_HIDRAULICA;
+    m_falhas[i] = f; // recebeu: limpa SEM_DADOS
+    m_t_ultima[i] = msg.recebida;
+}
+
+void AgregadorFrota::atuadores(int indice, const MensagemMQTT& msg)
+{
+    std::string_view txt;
+    ModoOperacao modo;
+    if (json_texto(msg.payload, "modo", txt) && modo_de_texto(txt, modo)) {
+        m_modo[static_cast<std::size_t>(indice)] = static_cast<std::uint8_t>(modo);
+    }
+}
+
+void AgregadorFrota::tratar_spawn(const std::string& payload)
+{
+    try {
+        const json data = json::parse(payload);
+        if (!data.contains("truck_id")) return;
+
+        // id removido que voltou: tira a marca, e a próxima mensagem o recria
+        para_cada_truck_id(data, [this](const std::string& id) {
+            if (!id_valido(id)) return;
+            const std::uint32_t rota = m_rotas.resolver("atr/" + id + "/sensor/raw");
+            if (rota != RoteadorTopicos::SEM_ROTA && m_rotas.indice(rota) == CAMINHAO_REMOVIDO) {
+                m_rotas.remover("atr/" + id + "/sensor/raw");
+                m_rotas.remover("atr/" + id + "/act");
+            }
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "[Agregador SPAWN] erro: " << e.what() << "\n";
+    }
+}
+
+void AgregadorFrota::tratar_remove(const std::string& payload)
+{
+    try {
+        const json data = json::parse(payload);
+        if (!data.contains("truck_id")) return;
+
+        para_cada_truck_id(data, [this](const std::string& id) {
+            if (!id_valido(id)) return;
+            const int i = indice_de(id);
+            if (i >= 0) remover(static_cast<std::size_t>(i));
+            else        marcar_removido(id); // removido antes da primeira mensagem
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "[Agregador REMOVE] erro: " << e.what() << "\n";
+    }
+}
+
+void AgregadorFrota::atualizar_timeouts(Clock::time_point agora)
+{
+    const auto limite = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_cfg.timeout_s));
+    for (std::size_t i = 0; i < m_id.size(); ++i) {
+        if (agora - m_t_ultima[i] > limite) m_falhas[i] |= SEM_DADOS;
+    }
+}
+
+// ---------------------------------------------------------------------
+// Quadros
+// ---------------------------------------------------------------------
+
+bool AgregadorFrota::montar_quadro(bool chave)
+{
+    const std::uint64_t quadro = m_quadro.load(std::memory_order_relaxed);
+    char tmp[160];
+
+    m_saida.clear();
+    if (chave) {
+        std::snprintf(tmp, sizeof(tmp), "{\"quadro\":%llu,\"chave\":true,\"t\":%.3f,\"c\":{",
+                      static_cast<unsigned long long>(quadro), agora_epoch());
+    } else {
+        std::snprintf(tmp, sizeof(tmp), "{\"quadro\":%llu,\"base\":%llu,\"t\":%.3f,\"c\":{",
+                      static_cast<unsigned long long>(quadro + 1),
+                      static_cast<unsigned long long>(quadro), agora_epoch());
+    }
+    m_saida += tmp;
+
+    bool algum = false;
+    for (std::size_t i = 0; i < m_id.size(); ++i) {
+        const bool todos = chave || m_novo[i];
+        const bool dx = todos || std::fabs(m_x[i] - m_env_x[i]) > m_cfg.tol_pos;
+        const bool dy = todos || std::fabs(m_y[i] - m_env_y[i]) > m_cfg.tol_pos;
+        const bool da = todos || std::fabs(m_ang[i] - m_env_ang[i]) > m_cfg.tol_ang;
+        const bool dt = todos || std::fabs(m_temp[i] - m_env_temp[i]) > m_cfg.tol_temp;
+        const bool dm = (todos || m_modo[i] != m_env_modo[i]) && m_modo[i] != MODO_DESCONHECIDO;
+        const bool df = todos || m_falhas[i] != m_env_falhas[i];
+        if (!(dx || dy || da || dt || dm || df)) continue;
+
+        if (algum) m_saida += ',';
+        json_anexar_texto(m_saida, m_id[i]); // o id vem do tópico: escapado
+        m_saida += ":{";
+        bool campo = false;
+        auto numero = [&](const char* nome, double v, const char* fmt) {
+            m_saida += campo ? ",\"" : "\"";
+            m_saida += nome;
+            m_saida += "\":";
+            std::snprintf(tmp, sizeof(tmp), fmt, v);
+            m_saida += tmp;
+            campo = true;
+        };
+        // só publica a posição de quem já mandou amostra
+        const bool com_dados = !(m_novo[i] && (m_falhas[i] & SEM_DADOS));
+        if (dx && com_dados) { numero("x", m_x[i], "%.2f");      if (!chave) m_env_x[i] = m_x[i]; }
+        if (dy && com_dados) { numero("y", m_y[i], "%.2f");      if (!chave) m_env_y[i] = m_y[i]; }
+        if (da && com_dados) { numero("ang", m_ang[i], "%.1f");  if (!chave) m_env_ang[i] = m_ang[i]; }
+        if (dt && com_dados) { numero("temp", m_temp[i], "%.1f"); if (!chave) m_env_temp[i] = m_temp[i]; }
+        if (dm) {
+            m_saida += campo ? ",\"modo\":\"" : "\"modo\":\"";
+            m_saida += nome_modo(static_cast<ModoOperacao>(m_modo[i]));
+            m_saida += '"';
+            campo = true;
+            if (!chave) m_env_modo[i] = m_modo[i];
+        }
+        if (df) {
+            numero("falhas", m_falhas[i], "%.0f");
+            if (!chave) m_env_falhas[i] = m_falhas[i];
+        }
+        m_saida += '}';
+        if (!chave) m_novo[i] = 0;
+        algum = true;
+    }
+    m_saida += '}';
+
+    if (!chave && !m_removidos.empty()) {
+        m_saida += ",\"rem\":[";
+        for (std::size_t k = 0; k < m_removidos.size(); ++k) {
+            if (k) m_saida += ',';
+            json_anexar_texto(m_saida, m_removidos[k]);
+        }
+        m_saida += ']';
+        m_removidos.clear();
+        algum = true;
+    }
+    m_saida += '}';
+    return chave || algum;
+}
+
+void AgregadorFrota::publicar_quadro(bool chave)
+{
+    // o quadro-chave reflete o que as interfaces já têm (valores enviados),
+    // então é montado a partir do estado enviado
+    if (chave) {
+        std::swap(m_x, m_env_x); std::swap(m_y, m_env_y);
+        std::swap(m_ang, m_env_ang); std::swap(m_temp, m_env_temp);
+        std::swap(m_modo, m_env_modo); std::swap(m_falhas, m_env_falhas);
+    }
+    const bool publicar = montar_quadro(chave);
+    if (chave) {
+        std::swap(m_x, m_env_x); std::swap(m_y, m_env_y);
+        std::swap(m_ang, m_env_ang); std::swap(m_temp, m_env_temp);
+        std::swap(m_modo, m_env_modo); std::swap(m_falhas, m_env_falhas);
+    }
+    if (!publicar) return;
+
+    const std::string& topico = chave ? TOPICO_ESTADO : TOPICO_DELTA;
+    try {
+        m_cli.publicar(topico, m_saida, qos_do_topico(topico), chave);
+        m_bytes_saida.fetch_add(m_saida.size(), std::memory_order_relaxed);
+        if (!chave) m_quadro.fetch_add(1, std::memory_order_relaxed);
+    } catch (const std::exception& e) {
+        // delta perdido: as interfaces se ressincronizam no próximo quadro-chave
+        std::cerr << "[Agregador] quadro não publicado: " << e.what() << "\n";
+        if (!chave) m_quadro.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AgregadorFrota::executar(const std::atomic<bool>& parar)
+{
+    const auto periodo = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / (m_cfg.hz > 0.0 ? m_cfg.hz : 5.0)));
+    const auto periodo_chave = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_cfg.intervalo_chave_s));
+
+    auto proximo = Clock::now() + periodo;
+    auto proxima_chave = Clock::now() + periodo_chave;
+
+    while (!parar.load()) {
+        const auto agora = Clock::now();
+        if (agora >= proximo) {
+            atualizar_timeouts(agora);
+            publicar_quadro(false);
+            if (agora >= proxima_chave) {
+                publicar_quadro(true);
+                proxima_chave = agora + periodo_chave;
+            }
+            proximo += periodo;
+            if (proximo < agora) proximo = agora + periodo; // atrasou: não acumula quadros
+            continue;
+        }
+
+        MensagemPtr msg;
+        const auto espera = std::chrono::duration_cast<std::chrono::milliseconds>(proximo - agora);
+        if (!m_cli.consumir_por(msg, std::max(espera, std::chrono::milliseconds(1))) || !msg) continue;
+
+        m_bytes_entrada.fetch_add(msg->topico.size() + msg->payload.size(), std::memory_order_relaxed);
+        const std::uint32_t rota = m_rotas.resolver(msg->topico);
+        if (rota == RoteadorTopicos::SEM_ROTA) continue;
+        // caminhão novo: cria e registra as rotas literais antes de despachar
+        if (m_rotas.indice(rota) == CAMINHAO_NOVO && indice_do_topico(msg->topico) < 0) continue;
+        m_rotas.despachar(*msg);
+    }
+}
+
+} // namespace atr
@@ -1,24 +1,68 @@
+#include "Buffer_Circular.h"
+
+#include <atomic>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
 
 BufferCircular::BufferCircular(std::size_t capacidade)
-    : buffer_(capacidade), capacidade_(capacidade) {}
+    : buffer_(std::make_unique<Slot[]>(capacidade)), capacidade_(capacidade) {}
 
 // ---------------------------------------------------------------------
-// Escreve uma nova posição tratada no buffer circular
+// Escreve uma nova posição tratada no buffer circular (único escritor)
 // ---------------------------------------------------------------------
 void BufferCircular::set_posicao_tratada(const PosicaoData& pos)
 {
-    buffer_[fim_] = pos;
-    fim_ = (fim_ + 1) % capacidade_;
+    const std::uint64_t n = escritos_.load(std::memory_order_relaxed);
 
-    if (tamanho_ < capacidade_) {
-        ++tamanho_;
-    } else {
-        // Sobrescreve o mais antigo
-        inicio_ = (inicio_ + 1) % capacidade_;
-    }
+    // Anuncia que o slot de 'n' (o mais antigo, se cheio) vai ser sobrescrito
+    iniciados_.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    buffer_[n % capacidade_].gravar(pos);
+
+    // Publica a nova posição para os leitores
+    escritos_.store(n + 1, std::memory_order_release);
+}
+
+std::size_t BufferCircular::tamanho() const
+{
+    const std::uint64_t e = escritos_.load(std::memory_order_acquire);
+    return e < capacidade_ ? static_cast<std::size_t>(e) : capacidade_;
+}
+
+// ---------------------------------------------------------------------
+// Instantâneo sem cópia: até dois trechos contíguos do anel
+// ---------------------------------------------------------------------
+BufferCircular::Instantaneo BufferCircular::instantaneo() const
+{
+    Instantaneo inst;
+    const std::uint64_t e = escritos_.load(std::memory_order_acquire);
+    const std::size_t n = e < capacidade_ ? static_cast<std::size_t>(e) : capacidade_;
+    if (n == 0) return inst;
+
+    inst.seq_inicio = e - n;
+    const std::size_t idx0 = static_cast<std::size_t>(inst.seq_inicio % capacidade_);
+
+    inst.parte1 = &buffer_[idx0];
+    inst.tam1   = (n < capacidade_ - idx0) ? n : capacidade_ - idx0;
+    inst.parte2 = buffer_.get();
+    inst.tam2   = n - inst.tam1;
+    return inst;
+}
+
+std::size_t BufferCircular::sobrescritos(const Instantaneo& inst) const
+{
+    // Ordena as leituras do instantâneo antes da releitura de 'iniciados_'
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t i = iniciados_.load(std::memory_order_relaxed);
+
+    // a sequência s só é sobrescrita pela escrita s + capacidade_
+    const std::uint64_t limite = i > capacidade_ ? i - capacidade_ : 0;
+    if (limite <= inst.seq_inicio) return 0;
+
+    const std::uint64_t perdidos = limite - inst.seq_inicio;
+    return perdidos < inst.tamanho() ? static_cast<std::size_t>(perdidos) : inst.tamanho();
 }
 
 // ---------------------------------------------------------------------
@@ -26,11 +70,19 @@ void BufferCircular::set_posicao_tratada(const PosicaoData& pos)
 // ---------------------------------------------------------------------
 BufferCircular::PosicaoData BufferCircular::get_posicao_recente() const
 {
-    if (tamanho_ == 0) {
-        return PosicaoData{}; // vazio
+    while (true) {
+        const std::uint64_t e = escritos_.load(std::memory_order_acquire);
+        if (e == 0) {
+            return PosicaoData{}; // vazio
+        }
+        const PosicaoData pos = buffer_[(e - 1) % capacidade_].ler();
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // válida se o escritor ainda não começou a sobrescrever a sequência e-1
+        if (iniciados_.load(std::memory_order_relaxed) < e + capacidade_) {
+            return pos;
+        }
     }
-    std::size_t ultimo = (fim_ + capacidade_ - 1) % capacidade_;
-    return buffer_[ultimo];
 }
 
 // ---------------------------------------------------------------------
@@ -38,16 +90,95 @@ BufferCircular::PosicaoData BufferCircular::get_posicao_recente() const
 // ---------------------------------------------------------------------
 std::vector<BufferCircular::PosicaoData> BufferCircular::get_todas() const
 {
-    std::vector<PosicaoData> saida;
-    saida.reserve(tamanho_);
+    // só o ocupado: com o anel ainda enchendo, não aloca capacidade_ posições.
+    // Se o escritor avançar até a cópia, copiar_todas mantém as mais recentes.
+    std::vector<PosicaoData> saida(instantaneo().tamanho());
+    saida.resize(copiar_todas(saida.data(), saida.size()));
+    return saida;
+}
 
-    for (std::size_t i = 0; i < tamanho_; ++i) {
-        std::size_t idx = (inicio_ + i) % capacidade_;
-        saida.push_back(buffer_[idx]);
-    }
+// ---------------------------------------------------------------------
+// Mesma cópia, em vetor do recurso do chamador (arena do ciclo)
+// ---------------------------------------------------------------------
+std::pmr::vector<BufferCircular::PosicaoData>
+BufferCircular::get_todas(std::pmr::memory_resource* recurso) const
+{
+    std::pmr::vector<PosicaoData> saida(instantaneo().tamanho(), recurso);
+    saida.resize(copiar_todas(saida.data(), saida.size()));
     return saida;
 }
 
+// ---------------------------------------------------------------------
+// Copia as posições para um destino do chamador (sem alocar)
+// ---------------------------------------------------------------------
+std::size_t BufferCircular::copiar_todas(PosicaoData* destino, std::size_t maximo) const
+{
+    const Instantaneo inst = instantaneo();
+    const std::size_t n = (inst.tamanho() < maximo) ? inst.tamanho() : maximo;
+    const std::size_t pular = inst.tamanho() - n; // mantém as 'n' mais recentes
+
+    for (std::size_t i = 0; i < n; ++i) {
+        destino[i] = inst[pular + i];
+    }
+
+    // Descarta o que o escritor sobrescreveu durante a cópia
+    const std::size_t perdidos = sobrescritos(inst);
+    if (perdidos <= pular) return n;
+
+    const std::size_t invalidos = perdidos - pular;
+    for (std::size_t i = invalidos; i < n; ++i) {
+        destino[i - invalidos] = destino[i];
+    }
+    return n - invalidos;
+}
+
+// ---------------------------------------------------------------------
+// Setpoints de navegação (escritos pelo Planejamento de Rota)
+// ---------------------------------------------------------------------
+void BufferCircular::set_setpoints_navegacao(const SetpointsNavegacao& sp)
+{
+    std::lock_guard<std::mutex> lk(setpoints_mutex_);
+    setpoints_ = sp;
+}
+
+BufferCircular::SetpointsNavegacao BufferCircular::get_setpoints_navegacao() const
+{
+    std::lock_guard<std::mutex> lk(setpoints_mutex_);
+    return setpoints_;
+}
+
+// ---------------------------------------------------------------------
+// Controle de navegação (escrito pelo Controle de Navegação)
+// ---------------------------------------------------------------------
+void BufferCircular::set_controle_navegacao(const ControleNavegacao& c)
+{
+    std::lock_guard<std::mutex> lk(setpoints_mutex_);
+    controle_ = c;
+}
+
+BufferCircular::ControleNavegacao BufferCircular::get_controle_navegacao() const
+{
+    std::lock_guard<std::mutex> lk(setpoints_mutex_);
+    return controle_;
+}
+
+// ---------------------------------------------------------------------
+// Comandos do operador: fila de até 7 comandos em um atômico de 32 bits
+// ---------------------------------------------------------------------
+bool BufferCircular::enviar_comando(atr::ComandoOperador cmd)
+{
+    std::uint32_t atual = comandos_.load(std::memory_order_relaxed);
+    for (;;) {
+        const std::uint32_t n = atual & 0xFu;
+        if (n == 7) return false;
+        const std::uint32_t novo = (atual | (static_cast<std::uint32_t>(cmd) << (4 + 4 * n))) + 1;
+        if (comandos_.compare_exchange_weak(atual, novo, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
 // ---------------------------------------------------------------------
 // Retorna referência ao mutex interno (para uso em lock externo)
 // ---------------------------------------------------------------------
@@ -0,0 +1,664 @@
+/**
+ * @file Cliente_MQTT.cpp
+ * @brief Implementação dos transportes MQTT (Paho e broker local).
+ *
+ * @objetivo Fornecer às tarefas um único tipo de cliente (ClienteMQTT),
+ * independente de o núcleo estar ligado a um broker real (Paho) ou ao
+ * BrokerLocal em processo, usado para carga sintética sem rede.
+ *
+ * @mecanismo (Interno)
+ * - CaixaEntrada: fila + condition_variable (modo consumer) ou callback.
+ *   É compartilhada (shared_ptr) com o transporte, para que uma entrega
+ *   em andamento nunca alcance um cliente já destruído.
+ * - Mensagens saem de um PoolMensagens por cliente e a fila é um anel
+ *   que só cresce no aquecimento: em regime, receber e consumir uma
+ *   mensagem não usa o heap nas threads das tarefas.
+ * - Tópicos ULTIMO_VALOR: se a fila já tem uma mensagem do mesmo tópico,
+ *   a nova ocupa o lugar dela (o consumidor atrasado lê só o dado novo).
+ * - BrokerLocal: singleton com as assinaturas (indexadas por um
+ *   RoteadorTopicos) e as mensagens retidas; a entrega é feita fora do
+ *   mutex do broker, de modo que um callback pode publicar de novo sem
+ *   deadlock.
+ * - Reconexão (Paho): o handler de conexão perdida só acorda uma thread
+ *   do cliente, que refaz connect + assinatura em lote com backoff; as
+ *   threads do Paho nunca bloqueiam esperando o broker.
+ */
+#include "Cliente_MQTT.h"
+#include "Roteador_Topicos.h"
+#include "Pool_Mensagens.h"
+#include "Arena_Tarefa.h"
+#include "Marcos_Inicializacao.h"
+#include "Politicas_Entrega.h"
+
+#include <mqtt/async_client.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace atr {
+
+// =====================================================================
+// Seleção de transporte
+// =====================================================================
+
+static std::atomic<TransporteMQTT> g_transporte{TransporteMQTT::PAHO};
+
+void definir_transporte_mqtt(TransporteMQTT transporte) {
+    g_transporte.store(transporte);
+}
+
+TransporteMQTT transporte_mqtt() {
+    return g_transporte.load();
+}
+
+bool transporte_de_texto(const std::string& texto, TransporteMQTT& saida) {
+    if (texto == "paho") {
+        saida = TransporteMQTT::PAHO;
+        return true;
+    }
+    if (texto == "local") {
+        saida = TransporteMQTT::LOCAL;
+        return true;
+    }
+    return false;
+}
+
+std::string uri_broker(const std::string& host, int porta) {
+    return "tcp://" + host + ":" + std::to_string(porta);
+}
+
+// ---------------------------------------------------------------------
+// Casamento de tópicos MQTT, nível a nível, sem alocar
+// ---------------------------------------------------------------------
+bool topico_corresponde(const std::string& filtro, const std::string& topico)
+{
+    // tópicos de sistema ($SYS/...) não casam com curingas no primeiro nível
+    if (!topico.empty() && topico[0] == '$' &&
+        !filtro.empty() && (filtro[0] == '+' || filtro[0] == '#')) {
+        return false;
+    }
+
+    std::size_t f = 0, t = 0;
+    bool fim_filtro = false, fim_topico = false;
+
+    while (!fim_filtro) {
+        std::size_t ff = filtro.find('/', f);
+        if (ff == std::string::npos) ff = filtro.size();
+        const std::string_view nivel_f(filtro.data() + f, ff - f);
+
+        // '#' casa o restante, inclusive o nível pai ("a/#" casa "a")
+        if (nivel_f == "#") return true;
+        if (fim_topico) return false;
+
+        std::size_t tf = topico.find('/', t);
+        if (tf == std::string::npos) tf = topico.size();
+        const std::string_view nivel_t(topico.data() + t, tf - t);
+
+        if (nivel_f != "+" && nivel_f != nivel_t) return false;
+
+        fim_filtro = (ff == filtro.size());
+        fim_topico = (tf == topico.size());
+        f = ff + 1;
+        t = tf + 1;
+    }
+    return fim_topico;
+}
+
+// =====================================================================
+// Backoff de reconexão
+// =====================================================================
+
+std::chrono::milliseconds PoliticaReconexao::espera(int tentativa) const
+{
+    // teto dobra a cada tentativa; o sorteio em [teto/2, teto] espalha
+    // no tempo os clientes que caíram juntos (ex.: broker reiniciado)
+    const auto limite = std::max(maximo.count(), inicial.count());
+    auto teto = std::max<std::chrono::milliseconds::rep>(inicial.count(), 1);
+    for (int k = 0; k < tentativa && teto < limite; ++k) teto *= 2;
+    teto = std::min(teto, limite);
+
+    thread_local std::mt19937 rng{std::random_device{}()};
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> sorteio(teto / 2, teto);
+    return std::chrono::milliseconds(sorteio(rng));
+}
+
+// =====================================================================
+// CaixaEntrada: destino das mensagens de um cliente
+// =====================================================================
+
+struct CaixaEntrada {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::shared_ptr<const ClienteMQTT::Callback> callback;
+    bool consumindo = false;
+    bool ativa = true;
+    int callbacks_em_voo = 0;
+
+    // fila em anel: dobra de tamanho quando enche (só no aquecimento)
+    std::vector<MensagemPtr> anel = std::vector<MensagemPtr>(64);
+    std::size_t cabeca = 0;
+    std::size_t ocupados = 0;
+    std::uint64_t removidos = 0; // sequência da mensagem em anel[cabeca]
+
+    // ULTIMO_VALOR: tópico -> sequência da sua mensagem mais recente na fila
+    // (cresce só com tópicos novos; busca por string_view, sem alocar)
+    std::map<std::string, std::uint64_t, std::less<>> ultimo_na_fila;
+    std::uint64_t substituidas = 0;
+
+    void empilhar(const MensagemPtr& msg) {
+        if (ocupados == anel.size()) {
+            std::vector<MensagemPtr> maior(anel.size() * 2);
+            for (std::size_t i = 0; i < ocupados; ++i) {
+                maior[i] = std::move(anel[(cabeca + i) % anel.size()]);
+            }
+            anel.swap(maior);
+            cabeca = 0;
+        }
+        anel[(cabeca + ocupados) % anel.size()] = msg;
+        ++ocupados;
+    }
+
+    MensagemPtr desempilhar() {
+        MensagemPtr msg = std::move(anel[cabeca]);
+        cabeca = (cabeca + 1) % anel.size();
+        --ocupados;
+        ++removidos;
+        return msg;
+    }
+
+    // coloca a mensagem na fila; 'ultimo_valor' substitui a pendente do mesmo tópico
+    void enfileirar(const MensagemPtr& msg, bool ultimo_valor) {
+        if (!ultimo_valor) {
+            empilhar(msg);
+            return;
+        }
+        auto it = ultimo_na_fila.find(std::string_view(msg->topico));
+        if (it != ultimo_na_fila.end() && it->second >= removidos) {
+            // ainda na fila: mantém a posição, troca pelo dado mais novo
+            anel[(cabeca + (it->second - removidos)) % anel.size()] = msg;
+            ++substituidas;
+            return;
+        }
+        const std::uint64_t seq = removidos + ocupados;
+        empilhar(msg);
+        if (it != ultimo_na_fila.end()) it->second = seq;
+        else                            ultimo_na_fila.emplace(msg->topico, seq);
+    }
+
+    void esvaziar() {
+        while (ocupados > 0) desempilhar();
+    }
+
+    void entregar(const MensagemPtr& msg) {
+        // resolvida fora do mutex (a tabela é só leitura)
+        const bool ultimo_valor =
+            politica_do_topico(msg->topico) == PoliticaEntrega::ULTIMO_VALOR;
+
+        std::unique_lock<std::mutex> lk(mtx);
+        if (!ativa) return;
+
+        if (callback) {
+            // chama sem segurar o mutex: o callback pode publicar/consumir.
+            // Copia só o shared_ptr (a std::function em si não é copiada).
+            std::shared_ptr<const ClienteMQTT::Callback> cb = callback;
+            ++callbacks_em_voo;
+            lk.unlock();
+            try {
+                (*cb)(msg);
+            } catch (...) {
+                // um callback com erro não pode derrubar a thread do transporte
+            }
+            lk.lock();
+            --callbacks_em_voo;
+            cv.notify_all();
+            return;
+        }
+
+        if (consumindo) {
+            const std::size_t antes = ocupados;
+            enfileirar(msg, ultimo_valor);
+            if (ocupados != antes) cv.notify_one();
+        }
+    }
+};
+
+// =====================================================================
+// ClienteMQTT (parte comum: consumo)
+// =====================================================================
+
+ClienteMQTT::ClienteMQTT()
+    : m_caixa(std::make_shared<CaixaEntrada>()),
+      m_pool(std::make_unique<PoolMensagens>()) {}
+
+ClienteMQTT::~ClienteMQTT() = default;
+
+void ClienteMQTT::iniciar_consumo() {
+    std::lock_guard<std::mutex> lk(m_caixa->mtx);
+    m_caixa->consumindo = true;
+}
+
+void ClienteMQTT::parar_consumo() {
+    {
+        std::lock_guard<std::mutex> lk(m_caixa->mtx);
+        m_caixa->consumindo = false;
+        m_caixa->esvaziar();
+    }
+    m_caixa->cv.notify_all();
+}
+
+bool ClienteMQTT::consumir_por(MensagemPtr& msg, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lk(m_caixa->mtx);
+    if (!m_caixa->cv.wait_for(lk, timeout, [this] {
+            return m_caixa->ocupados > 0 || !m_caixa->consumindo;
+        })) {
+        return false;
+    }
+    if (m_caixa->ocupados == 0) return false;
+
+    msg = m_caixa->desempilhar();
+    return true;
+}
+
+MensagemPtr ClienteMQTT::consumir() {
+    std::unique_lock<std::mutex> lk(m_caixa->mtx);
+    m_caixa->cv.wait(lk, [this] {
+        return m_caixa->ocupados > 0 || !m_caixa->consumindo;
+    });
+    if (m_caixa->ocupados == 0) return nullptr;
+
+    return m_caixa->desempilhar();
+}
+
+void ClienteMQTT::definir_callback(Callback cb) {
+    auto compartilhado = cb ? std::make_shared<const Callback>(std::move(cb)) : nullptr;
+    std::lock_guard<std::mutex> lk(m_caixa->mtx);
+    m_caixa->callback = std::move(compartilhado);
+}
+
+void ClienteMQTT::conectar_sessao(const std::vector<Assinatura>& lote, const std::string& nome,
+                                  const PoliticaReconexao& politica)
+{
+    const auto inicio = std::chrono::steady_clock::now();
+    for (int tentativa = 0;; ++tentativa) {
+        try {
+            if (!conectado()) conectar();
+            if (!lote.empty()) assinar_lote(lote);
+
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - inicio).count();
+            registrar_marco(nome + ": sessão MQTT pronta (" + std::to_string(lote.size()) +
+                            " filtros, " + std::to_string(tentativa + 1) + " tentativa(s), " +
+                            std::to_string(ms) + " ms)");
+            break;
+        } catch (const std::exception& e) {
+            const auto espera = politica.espera(tentativa);
+            std::cerr << "[" << nome << "] Falha ao conectar (" << e.what() << "). Nova tentativa em "
+                      << espera.count() << " ms.\n";
+            std::this_thread::sleep_for(espera);
+        }
+    }
+    manter_sessao(lote, nome, politica);
+}
+
+void ClienteMQTT::manter_sessao(const std::vector<Assinatura>&, const std::string&,
+                                const PoliticaReconexao&) {}
+
+std::uint64_t ClienteMQTT::substituidas() const {
+    std::lock_guard<std::mutex> lk(m_caixa->mtx);
+    return m_caixa->substituidas;
+}
+
+std::shared_ptr<MensagemMQTT> ClienteMQTT::nova_mensagem() {
+    return m_pool->adquirir();
+}
+
+void ClienteMQTT::entregar(const MensagemPtr& msg) {
+    m_caixa->entregar(msg);
+}
+
+void ClienteMQTT::encerrar_entrega() {
+    std::unique_lock<std::mutex> lk(m_caixa->mtx);
+    m_caixa->ativa = false;
+    m_caixa->consumindo = false;
+    m_caixa->esvaziar();
+    m_caixa->cv.notify_all();
+    m_caixa->cv.wait(lk, [this] { return m_caixa->callbacks_em_voo == 0; });
+    m_caixa->callback = nullptr;
+}
+
+// =====================================================================
+// Transporte Paho
+// =====================================================================
+
+namespace {
+
+class ClientePaho : public ClienteMQTT {
+public:
+    // publicações guardadas enquanto a conexão é refeita (enviadas ao reconectar)
+    static constexpr int MAX_PUBLICACOES_OFFLINE = 1000;
+
+    ClientePaho(const std::string& uri, const std::string& client_id)
+        : m_cli(uri, client_id, MAX_PUBLICACOES_OFFLINE)
+    {
+        m_cli.set_message_callback([this](mqtt::const_message_ptr msg) {
+            if (!msg) return;
+            // assign reaproveita a capacidade da mensagem do pool
+            auto m = nova_mensagem();
+            m->topico.assign(msg->get_topic());
+            m->payload.assign(msg->get_payload_ref());
+            m->qos = msg->get_qos();
+            m->recebida = std::chrono::steady_clock::now();
+            entregar(m);
+        });
+        m_cli.set_connection_lost_handler([this](const std::string&) {
+            // só sinaliza: a reconexão bloqueia e roda na thread do cliente
+            {
+                std::lock_guard<std::mutex> lk(m_mtx_sessao);
+                m_perdida = true;
+            }
+            m_cv_sessao.notify_all();
+        });
+    }
+
+    ~ClientePaho() override {
+        {
+            std::lock_guard<std::mutex> lk(m_mtx_sessao);
+            m_encerrar = true;
+        }
+        m_cv_sessao.notify_all();
+        if (m_reconexao.joinable()) m_reconexao.join();
+
+        encerrar_entrega();
+        try {
+            if (m_cli.is_connected()) m_cli.disconnect()->wait();
+        } catch (...) {
+            // evitar exceção em destrutor
+        }
+    }
+
+    void conectar() override {
+        mqtt::connect_options opts;
+        opts.set_clean_session(true);
+        // falha rápido se o broker não responde; o backoff decide quando tentar de novo
+        opts.set_connect_timeout(std::chrono::seconds(2));
+        m_cli.connect(opts)->wait();
+    }
+
+    void desconectar() override {
+        m_cli.disconnect()->wait();
+    }
+
+    bool conectado() const override {
+        return m_cli.is_connected();
+    }
+
+    void assinar(const std::string& filtro, int qos) override {
+        m_cli.subscribe(filtro, qos)->wait();
+    }
+
+    void assinar_lote(const std::vector<Assinatura>& lote) override {
+        if (lote.empty()) return;
+        std::vector<std::string> filtros;
+        mqtt::qos_collection qos;
+        filtros.reserve(lote.size());
+        qos.reserve(lote.size());
+        for (const auto& a : lote) {
+            filtros.push_back(a.filtro);
+            qos.push_back(a.qos);
+        }
+        // um único SUBSCRIBE: uma ida e volta, qualquer que seja o tamanho do lote
+        m_cli.subscribe(mqtt::string_collection::create(filtros), qos)->wait();
+    }
+
+    void cancelar_assinatura(const std::string& filtro) override {
+        m_cli.unsubscribe(filtro)->wait();
+    }
+
+    void publicar(const std::string& topico, const std::string& payload,
+                  int qos, bool retido) override {
+        m_cli.publish(topico, payload, qos, retido);
+    }
+
+protected:
+    void manter_sessao(const std::vector<Assinatura>& lote, const std::string& nome,
+                       const PoliticaReconexao& politica) override {
+        std::lock_guard<std::mutex> lk(m_mtx_sessao);
+        m_lote = lote;
+        m_nome = nome;
+        m_politica = politica;
+        if (!m_reconexao.joinable()) {
+            m_reconexao = std::thread([this] { laco_reconexao(); });
+        }
+    }
+
+private:
+    mqtt::async_client m_cli;
+
+    // sessão mantida após conectar_sessao()
+    std::mutex m_mtx_sessao;
+    std::condition_variable m_cv_sessao;
+    std::vector<Assinatura> m_lote;
+    std::string m_nome;
+    PoliticaReconexao m_politica;
+    bool m_perdida = false;
+    bool m_encerrar = false;
+    std::thread m_reconexao;
+
+    void laco_reconexao() {
+        std::unique_lock<std::mutex> lk(m_mtx_sessao);
+        for (;;) {
+            m_cv_sessao.wait(lk, [this] { return m_perdida || m_encerrar; });
+            if (m_encerrar) return;
+            m_perdida = false;
+
+            const std::vector<Assinatura> lote = m_lote;
+            const std::string nome = m_nome;
+            const PoliticaReconexao politica = m_politica;
+            std::cerr << "[" << nome << "] Conexão MQTT perdida. Reconectando...\n";
+
+            const auto inicio = std::chrono::steady_clock::now();
+            for (int tentativa = 0; !m_encerrar; ++tentativa) {
+                // espera antes de tentar: espalha a frota que caiu junto
+                if (m_cv_sessao.wait_for(lk, politica.espera(tentativa), [this] { return m_encerrar; })) {
+                    return;
+                }
+                lk.unlock();
+                bool ok = false;
+                try {
+                    if (!m_cli.is_connected()) conectar();
+                    assinar_lote(lote);
+                    ok = true;
+                } catch (const std::exception& e) {
+                    std::cerr << "[" << nome << "] Reconexão falhou (" << e.what() << ").\n";
+                }
+                lk.lock();
+                if (ok) {
+                    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - inicio).count();
+                    std::cout << "[" << nome << "] Reconectado em " << ms << " ms ("
+                              << tentativa + 1 << " tentativa(s)).\n";
+                    break;
+                }
+            }
+        }
+    }
+};
+
+// =====================================================================
+// Transporte local (broker em processo)
+// =====================================================================
+
+class BrokerLocal {
+public:
+    static BrokerLocal& instancia() {
+        static BrokerLocal broker;
+        return broker;
+    }
+
+    void assinar(const std::shared_ptr<CaixaEntrada>& caixa,
+                 const std::string& filtro, int qos)
+    {
+        std::vector<MensagemPtr> retidas;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            const std::uint32_t id = m_filtros.internar(filtro);
+            if (id == RoteadorTopicos::SEM_ROTA) {
+                throw std::invalid_argument("filtro MQTT inválido: " + filtro);
+            }
+            if (id >= m_assinantes.size()) m_assinantes.resize(id + 1);
+
+            auto& lista = m_assinantes[id];
+            auto it = std::find_if(lista.begin(), lista.end(),
+                [&](const Assinante& a) { return a.caixa == caixa; });
+            if (it != lista.end()) {
+                it->qos = qos;
+            } else {
+                lista.push_back({qos, caixa});
+            }
+
+            for (const auto& par : m_retidas) {
+                if (topico_corresponde(filtro, par.first)) retidas.push_back(par.second);
+            }
+        }
+        for (const auto& msg : retidas) caixa->entregar(msg);
+    }
+
+    void cancelar(const CaixaEntrada* caixa, const std::string& filtro) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        const std::uint32_t id = m_filtros.internar(filtro);
+        if (id == RoteadorTopicos::SEM_ROTA) return;
+        if (id >= m_assinantes.size()) m_assinantes.resize(id + 1);
+        remover_de(id, caixa);
+    }
+
+    void remover(const CaixaEntrada* caixa) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (std::uint32_t id = 0; id < m_assinantes.size(); ++id) {
+            if (!m_assinantes[id].empty()) remover_de(id, caixa);
+        }
+    }
+
+    void publicar(const MensagemPtr& msg, bool retido) {
+        // lista de destinos na arena desta chamada (na pilha): a entrega pode
+        // rodar um callback que publica de novo, e a chamada aninhada usa a
+        // própria arena sem invalidar a lista que este laço ainda percorre
+        ArenaTarefa<2048> arena;
+        std::pmr::vector<std::shared_ptr<CaixaEntrada>> destinos(arena.recurso());
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            if (retido) {
+                // payload vazio apaga a retida (semântica MQTT)
+                if (msg->payload.empty()) m_retidas.erase(msg->topico);
+                else                      m_retidas[msg->topico] = msg;
+            }
+
+            m_filtros.para_cada(msg->topico, [&](std::uint32_t id) {
+                for (const auto& a : m_assinantes[id]) {
+                    // filtros sobrepostos do mesmo cliente recebem uma única cópia
+                    if (std::find(destinos.begin(), destinos.end(), a.caixa) == destinos.end()) {
+                        destinos.push_back(a.caixa);
+                    }
+                }
+            });
+        }
+        for (const auto& caixa : destinos) caixa->entregar(msg);
+    }
+
+private:
+    struct Assinante {
+        int qos;
+        std::shared_ptr<CaixaEntrada> caixa;
+    };
+
+    std::mutex m_mutex;
+    RoteadorTopicos m_filtros;                          // filtro -> id
+    std::vector<std::vector<Assinante>> m_assinantes;  // por id de filtro
+    std::map<std::string, MensagemPtr> m_retidas;
+
+    void remover_de(std::uint32_t id, const CaixaEntrada* caixa) {
+        auto& lista = m_assinantes[id];
+        lista.erase(std::remove_if(lista.begin(), lista.end(),
+                        [&](const Assinante& a) { return a.caixa.get() == caixa; }),
+                    lista.end());
+        // sem assinantes: o filtro deixa de ser visitado na trie
+        if (lista.empty()) m_filtros.remover(m_filtros.filtro(id));
+    }
+};
+
+class ClienteLocal : public ClienteMQTT {
+public:
+    ~ClienteLocal() override {
+        BrokerLocal::instancia().remover(caixa().get());
+        encerrar_entrega();
+    }
+
+    void conectar() override {
+        m_conectado.store(true);
+    }
+
+    void desconectar() override {
+        BrokerLocal::instancia().remover(caixa().get());
+        m_conectado.store(false);
+    }
+
+    bool conectado() const override {
+        return m_conectado.load();
+    }
+
+    void assinar(const std::string& filtro, int qos) override {
+        exigir_conexao();
+        BrokerLocal::instancia().assinar(caixa(), filtro, qos);
+    }
+
+    void assinar_lote(const std::vector<Assinatura>& lote) override {
+        exigir_conexao();
+        for (const auto& a : lote) BrokerLocal::instancia().assinar(caixa(), a.filtro, a.qos);
+    }
+
+    void cancelar_assinatura(const std::string& filtro) override {
+        exigir_conexao();
+        BrokerLocal::instancia().cancelar(caixa().get(), filtro);
+    }
+
+    void publicar(const std::string& topico, const std::string& payload,
+                  int qos, bool retido) override {
+        exigir_conexao();
+        auto m = nova_mensagem();
+        m->topico.assign(topico);
+        m->payload.assign(payload);
+        m->qos = qos;
+        m->recebida = std::chrono::steady_clock::now();
+        BrokerLocal::instancia().publicar(m, retido);
+    }
+
+private:
+    std::atomic<bool> m_conectado{false};
+
+    void exigir_conexao() const {
+        if (!m_conectado.load()) {
+            throw std::runtime_error("cliente MQTT local não conectado");
+        }
+    }
+};
+
+} // namespace
+
+std::unique_ptr<ClienteMQTT> criar_cliente_mqtt(const std::string& uri,
+                                                const std::string& client_id)
+{
+    if (transporte_mqtt() == TransporteMQTT::LOCAL) {
+        return std::make_unique<ClienteLocal>();
+    }
+    return std::make_unique<ClientePaho>(uri, client_id);
+}
+
+} // namespace atr
@@ -0,0 +1,71 @@
+/**
+ * @file Contador_Alocacoes.cpp
+ * @brief Substituição (opcional) de new/delete com contagem por thread.
+ *
+ * @objetivo Permitir provar que o caminho de uma mensagem em regime não
+ * usa o heap. Os contadores são thread_local (sem contenção entre as
+ * threads do Paho e as tarefas) e só existem quando o projeto é
+ * compilado com -DATR_CONTAR_ALOCACOES=ON.
+ */
+#include "Contador_Alocacoes.h"
+
+#ifdef ATR_CONTAR_ALOCACOES
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local std::uint64_t t_alocacoes = 0;
+thread_local std::uint64_t t_bytes     = 0;
+
+void* alocar(std::size_t n) {
+    ++t_alocacoes;
+    t_bytes += n;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* alocar_alinhado(std::size_t n, std::align_val_t al) {
+    ++t_alocacoes;
+    t_bytes += n;
+    const std::size_t a = static_cast<std::size_t>(al);
+    // aligned_alloc exige tamanho múltiplo do alinhamento
+    const std::size_t tam = ((n ? n : 1) + a - 1) / a * a;
+    if (void* p = std::aligned_alloc(a, tam)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t n)   { return alocar(n); }
+void* operator new[](std::size_t n) { return alocar(n); }
+void* operator new(std::size_t n, std::align_val_t al)   { return alocar_alinhado(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al) { return alocar_alinhado(n, al); }
+
+void operator delete(void* p) noexcept   { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept   { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept   { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+namespace atr {
+
+ContagemAlocacoes alocacoes_da_thread() {
+#ifdef ATR_CONTAR_ALOCACOES
+    return ContagemAlocacoes{t_alocacoes, t_bytes};
+#else
+    return ContagemAlocacoes{};
+#endif
+}
+
+bool contador_alocacoes_ativo() {
+#ifdef ATR_CONTAR_ALOCACOES
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace atr
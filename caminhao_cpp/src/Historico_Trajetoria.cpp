@@ -0,0 +1,231 @@
+/**
+ * @file Historico_Trajetoria.cpp
+ * @brief Implementação da classe HistoricoTrajetoria.
+ *
+ * @objetivo Manter, a cada posição tratada, os agregados de 1 s e de 10 s
+ * (min/max/média de x e y, média circular do ângulo) e responder
+ * consultas de janela no nível mais fino que couber no pedido.
+ */
+#include "Historico_Trajetoria.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+double ler_env(const char* nome, double padrao) {
+    const char* txt = std::getenv(nome);
+    if (!txt) return padrao;
+    char* fim = nullptr;
+    const double v = std::strtod(txt, &fim);
+    return (fim != txt && v > 0.0) ? v : padrao;
+}
+
+} // namespace
+
+// =====================================================================
+// ConfigHistorico
+// =====================================================================
+
+std::size_t ConfigHistorico::capacidade_bruta() const
+{
+    const double n = std::ceil(taxa_hz * janela_bruta_s);
+    return n < 1.0 ? 1 : static_cast<std::size_t>(n);
+}
+
+ConfigHistorico ConfigHistorico::do_ambiente()
+{
+    ConfigHistorico cfg;
+    cfg.taxa_hz        = ler_env("ATR_HISTORICO_TAXA_HZ", cfg.taxa_hz);
+    cfg.janela_bruta_s = ler_env("ATR_HISTORICO_BRUTO_S", cfg.janela_bruta_s);
+    cfg.janela_1hz_s   = ler_env("ATR_HISTORICO_1HZ_S",   cfg.janela_1hz_s);
+    cfg.janela_01hz_s  = ler_env("ATR_HISTORICO_01HZ_S",  cfg.janela_01hz_s);
+    return cfg;
+}
+
+// =====================================================================
+// Acumulador (agregado em aberto)
+// =====================================================================
+
+void HistoricoTrajetoria::Acumulador::somar(const Agregado& a)
+{
+    if (n == 0) {
+        xmin = a.x.min; xmax = a.x.max;
+        ymin = a.y.min; ymax = a.y.max;
+    } else {
+        xmin = std::min(xmin, a.x.min); xmax = std::max(xmax, a.x.max);
+        ymin = std::min(ymin, a.y.min); ymax = std::max(ymax, a.y.max);
+    }
+    xsoma += a.x.media * a.n;
+    ysoma += a.y.media * a.n;
+
+    const double rad = a.ang_medio * PI / 180.0;
+    cos_soma += std::cos(rad) * a.n;
+    sin_soma += std::sin(rad) * a.n;
+    n += a.n;
+}
+
+HistoricoTrajetoria::Agregado HistoricoTrajetoria::Acumulador::fechar(double periodo, bool aberto) const
+{
+    Agregado a;
+    a.aberto    = aberto;
+    a.t_inicio  = static_cast<double>(balde) * periodo;
+    a.duracao   = periodo;
+    a.n         = n;
+    a.x         = {xmin, xmax, xsoma / n};
+    a.y         = {ymin, ymax, ysoma / n};
+    a.ang_medio = std::atan2(sin_soma, cos_soma) * 180.0 / PI;
+    return a;
+}
+
+// =====================================================================
+// HistoricoTrajetoria
+// =====================================================================
+
+HistoricoTrajetoria::HistoricoTrajetoria(const BufferCircular& bruto, const ConfigHistorico& cfg)
+    : m_bruto(bruto),
+      m_cfg(cfg),
+      m_t0(Clock::now()),
+      m_anel_1s(static_cast<std::size_t>(std::ceil(cfg.janela_1hz_s))),
+      m_anel_10s(static_cast<std::size_t>(std::ceil(cfg.janela_01hz_s / 10.0)))
+{}
+
+double HistoricoTrajetoria::segundos(Clock::time_point t) const
+{
+    return std::chrono::duration<double>(t - m_t0).count();
+}
+
+void HistoricoTrajetoria::acumular(Acumulador& acc, const Agregado& a, double periodo,
+                                   bool& fechou, Agregado& fechado)
+{
+    const auto balde = static_cast<std::int64_t>(std::floor(a.t_inicio / periodo));
+    fechou = false;
+
+    if (acc.balde >= 0 && balde != acc.balde && acc.n > 0) {
+        fechado = acc.fechar(periodo);
+        fechou  = true;
+        acc = Acumulador{};
+    }
+    acc.balde = balde;
+    acc.somar(a);
+}
+
+// ---------------------------------------------------------------------
+// Escrita: O(1) por amostra; só espera pelo mutex ao fechar um agregado
+// ---------------------------------------------------------------------
+void HistoricoTrajetoria::registrar(const BufferCircular::PosicaoData& pos, Clock::time_point t)
+{
+    Agregado a;
+    a.t_inicio  = segundos(t);
+    a.n         = 1;
+    a.x         = {pos.i_pos_x, pos.i_pos_x, pos.i_pos_x};
+    a.y         = {pos.i_pos_y, pos.i_pos_y, pos.i_pos_y};
+    a.ang_medio = pos.i_angulo_x;
+
+    bool fechou_1s = false, fechou_10s = false;
+    Agregado ag_1s, ag_10s;
+
+    // os dois níveis recebem a amostra: o agregado em aberto de 10 s já
+    // inclui o segundo em andamento
+    acumular(m_acc_1s, a, 1.0, fechou_1s, ag_1s);
+    acumular(m_acc_10s, a, 10.0, fechou_10s, ag_10s);
+
+    // um agregado fechado não pode se perder; o em aberto, se uma consulta
+    // estiver com o mutex, é atualizado na próxima amostra
+    std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
+    if (fechou_1s || fechou_10s) lk.lock();
+    else                         lk.try_lock();
+
+    if (lk.owns_lock()) {
+        if (fechou_1s)  m_anel_1s.inserir(ag_1s);
+        if (fechou_10s) m_anel_10s.inserir(ag_10s);
+        m_aberto_1s  = m_acc_1s.fechar(1.0, true);
+        m_aberto_10s = m_acc_10s.fechar(10.0, true);
+        lk.unlock();
+    }
+    m_t_ultima.store(a.t_inicio, std::memory_order_release);
+}
+
+// ---------------------------------------------------------------------
+// Consulta: O(pontos devolvidos)
+// ---------------------------------------------------------------------
+std::size_t HistoricoTrajetoria::consultar(double janela_s, Agregado* destino, std::size_t maximo,
+                                           Nivel* nivel_usado) const
+{
+    if (maximo == 0 || janela_s <= 0.0) return 0;
+
+    const double pontos_brutos = std::ceil(janela_s * m_cfg.taxa_hz);
+    const double pontos_1s     = std::ceil(janela_s);
+
+    Nivel nivel = Nivel::SEG_10;
+    if (janela_s <= m_cfg.janela_bruta_s && pontos_brutos <= static_cast<double>(maximo)) {
+        nivel = Nivel::BRUTO;
+    } else if (janela_s <= m_cfg.janela_1hz_s && pontos_1s <= static_cast<double>(maximo)) {
+        nivel = Nivel::SEG_1;
+    }
+    if (nivel_usado) *nivel_usado = nivel;
+
+    if (nivel == Nivel::BRUTO) return copiar_bruto(janela_s, destino, maximo);
+
+    const double desde = m_t_ultima.load(std::memory_order_acquire) - janela_s;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (nivel == Nivel::SEG_1) return copiar_nivel(m_anel_1s, m_aberto_1s, desde, destino, maximo);
+    return copiar_nivel(m_anel_10s, m_aberto_10s, desde, destino, maximo);
+}
+
+std::size_t HistoricoTrajetoria::copiar_nivel(const Anel& anel, const Agregado& aberto, double desde,
+                                              Agregado* destino, std::size_t maximo) const
+{
+    // o agregado em aberto é o ponto mais recente; os fechados vêm antes dele
+    const bool com_aberto = aberto.n > 0 && aberto.t_inicio + aberto.duracao > desde;
+    const std::size_t maximo_fechados = com_aberto ? maximo - 1 : maximo;
+
+    // conta, a partir do mais recente, os agregados que terminam dentro da janela
+    std::size_t k = 0;
+    while (k < anel.tamanho() && k < maximo_fechados) {
+        const Agregado& a = anel.recente(k);
+        if (a.t_inicio + a.duracao <= desde) break;
+        ++k;
+    }
+    for (std::size_t i = 0; i < k; ++i) {
+        destino[k - 1 - i] = anel.recente(i);
+    }
+    if (com_aberto) destino[k++] = aberto;
+    return k;
+}
+
+std::size_t HistoricoTrajetoria::copiar_bruto(double janela_s, Agregado* destino, std::size_t maximo) const
+{
+    const double t_ultima = m_t_ultima.load(std::memory_order_acquire);
+    const BufferCircular::Instantaneo inst = m_bruto.instantaneo();
+    const std::size_t pedidos = static_cast<std::size_t>(std::ceil(janela_s * m_cfg.taxa_hz));
+    std::size_t n = std::min({inst.tamanho(), pedidos, maximo});
+    const std::size_t pular = inst.tamanho() - n;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const BufferCircular::PosicaoData p = inst[pular + i];
+        Agregado& a = destino[i];
+        a = Agregado{}; // destino reaproveitado entre pedidos: nada herdado (ex.: "aberto")
+        // instante de ingresso da amostra; sem carimbo, estimado pela taxa nominal
+        a.t_inicio  = p.carimbo.valido()
+                          ? segundos(Clock::time_point(std::chrono::nanoseconds(p.carimbo.t_ingresso_ns)))
+                          : t_ultima - static_cast<double>(n - 1 - i) / m_cfg.taxa_hz;
+        a.duracao   = 0.0;
+        a.n         = 1;
+        a.x         = {p.i_pos_x, p.i_pos_x, p.i_pos_x};
+        a.y         = {p.i_pos_y, p.i_pos_y, p.i_pos_y};
+        a.ang_medio = p.i_angulo_x;
+    }
+
+    // descarta o que o escritor sobrescreveu durante a cópia
+    const std::size_t perdidos = m_bruto.sobrescritos(inst);
+    if (perdidos > pular) {
+        const std::size_t invalidos = std::min(perdidos - pular, n);
+        std::copy(destino + invalidos, destino + n, destino);
+        n -= invalidos;
+    }
+    return n;
+}
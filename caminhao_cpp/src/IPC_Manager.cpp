@@ -18,6 +18,8 @@
  * enviar o "dicionário" de estados (posição, modo, falhas) 
  * para a 'interface_local'.
  */
+#include "IPC_Manager.h"
+
 #include <iostream>
 #include <string>
 
@@ -31,6 +33,6 @@ std::string IpcManager::receber_comando() {
     return "";
 }
 
-void IpcManager::enviar_estado(const std::string& estado) {
+void IpcManager::enviar_estado(const std::string& /*estado*/) {
     // Simula o envio
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+/**
+ * @file Json_Plano.cpp
+ * @brief Implementação da leitura de campos de JSON plano.
+ *
+ * @mecanismo (Interno)
+ * Procura "<chave>" seguido de ':' e interpreta o valor no lugar, com
+ * std::from_chars (sem locale e sem alocação).
+ *
+ * json_anexar_texto() é o caminho inverso para textos: escreve uma
+ * string JSON escapada no fim de um std::string.
+ */
+#include "Json_Plano.h"
+
+#include <charconv>
+
+namespace atr {
+
+namespace {
+
+inline bool espaco(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Posição do primeiro caractere do valor de "chave", ou npos.
+std::size_t inicio_valor(std::string_view json, std::string_view chave)
+{
+    std::size_t pos = 0;
+    while ((pos = json.find(chave, pos)) != std::string_view::npos) {
+        const std::size_t fim = pos + chave.size();
+        const bool entre_aspas = pos > 0 && json[pos - 1] == '"' &&
+                                 fim < json.size() && json[fim] == '"';
+        if (entre_aspas) {
+            std::size_t i = fim + 1;
+            while (i < json.size() && espaco(json[i])) ++i;
+            if (i < json.size() && json[i] == ':') {
+                ++i;
+                while (i < json.size() && espaco(json[i])) ++i;
+                if (i < json.size()) return i;
+            }
+        }
+        pos = fim;
+    }
+    return std::string_view::npos;
+}
+
+} // namespace
+
+bool json_numero(std::string_view json, std::string_view chave, double& saida)
+{
+    const std::size_t i = inicio_valor(json, chave);
+    if (i == std::string_view::npos) return false;
+
+    double v = 0.0;
+    const auto r = std::from_chars(json.data() + i, json.data() + json.size(), v);
+    if (r.ec != std::errc()) return false;
+    saida = v;
+    return true;
+}
+
+bool json_booleano(std::string_view json, std::string_view chave, bool& saida)
+{
+    const std::size_t i = inicio_valor(json, chave);
+    if (i == std::string_view::npos) return false;
+
+    const std::string_view resto = json.substr(i);
+    if (resto.compare(0, 4, "true") == 0 || resto.compare(0, 1, "1") == 0) {
+        saida = true;
+        return true;
+    }
+    if (resto.compare(0, 5, "false") == 0 || resto.compare(0, 1, "0") == 0) {
+        saida = false;
+        return true;
+    }
+    return false;
+}
+
+bool json_texto(std::string_view json, std::string_view chave, std::string_view& saida)
+{
+    const std::size_t i = inicio_valor(json, chave);
+    if (i == std::string_view::npos || json[i] != '"') return false;
+
+    const std::size_t fim = json.find('"', i + 1);
+    if (fim == std::string_view::npos) return false;
+    saida = json.substr(i + 1, fim - i - 1);
+    return true;
+}
+
+void json_anexar_texto(std::string& saida, std::string_view texto)
+{
+    static const char HEX[] = "0123456789abcdef";
+    saida += '"';
+    for (const char c : texto) {
+        const auto u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            saida += '\\';
+            saida += c;
+        } else if (u < 0x20) {
+            saida += "\\u00";
+            saida += HEX[u >> 4];
+            saida += HEX[u & 0xF];
+        } else {
+            saida += c;
+        }
+    }
+    saida += '"';
+}
+
+} // namespace atr
@@ -0,0 +1,88 @@
+/**
+ * @file Marcos_Inicializacao.cpp
+ * @brief Implementação da medição do tempo de inicialização.
+ */
+#include "Marcos_Inicializacao.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace atr {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// segundos decorridos desde a subida do container, se o start.sh informou
+bool desde_container(double& decorrido) {
+    const char* t0 = std::getenv("ATR_T0_CONTAINER");
+    if (!t0) return false;
+    char* fim = nullptr;
+    const double inicio = std::strtod(t0, &fim);
+    if (fim == t0) return false;
+
+    const double agora = std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    decorrido = agora - inicio;
+    return decorrido >= 0.0;
+}
+
+// segundos decorridos desde o início deste processo (Linux)
+bool desde_processo(double& decorrido) {
+    std::ifstream stat("/proc/self/stat");
+    std::ifstream uptime("/proc/uptime");
+    std::string linha;
+    double segundos_boot = 0.0;
+    if (!std::getline(stat, linha) || !(uptime >> segundos_boot)) return false;
+
+    // o nome do executável (campo 2) pode ter espaços: pula até o último ')'
+    const std::size_t p = linha.rfind(')');
+    if (p == std::string::npos) return false;
+    std::istringstream campos(linha.substr(p + 2));
+    std::string campo;
+    // campos a partir do 3 (state); starttime é o 22
+    for (int i = 3; i < 22; ++i) campos >> campo;
+    unsigned long long ticks = 0;
+    if (!(campos >> ticks)) return false;
+
+    const long hz = ::sysconf(_SC_CLK_TCK);
+    if (hz <= 0) return false;
+    decorrido = segundos_boot - static_cast<double>(ticks) / static_cast<double>(hz);
+    return decorrido >= 0.0;
+}
+
+Clock::time_point origem() {
+    static const Clock::time_point t0 = [] {
+        double decorrido = 0.0;
+        if (!desde_container(decorrido) && !desde_processo(decorrido)) decorrido = 0.0;
+        return Clock::now() - std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double>(decorrido));
+    }();
+    return t0;
+}
+
+} // namespace
+
+void marcar_inicio_processo() {
+    (void)origem();
+}
+
+double segundos_desde_inicio() {
+    return std::chrono::duration<double>(Clock::now() - origem()).count();
+}
+
+void registrar_marco(const std::string& descricao) {
+    std::ostringstream linha;
+    linha << "[Inicialização] +" << std::fixed << std::setprecision(3)
+          << segundos_desde_inicio() << " s: " << descricao << "\n";
+    std::cout << linha.str();
+}
+
+} // namespace atr
@@ -18,34 +18,96 @@
  * @saidas (Outputs) - Para a thread que dispara
  * 1. Chamada de 'disparar_evento()' pela thread publicadora 
  * (Monitoramento de Falhas).
+ *
+ * Cada evento leva o carimbo da leitura que o gerou; quem o recebe
+ * registra no trace a latência disparo -> assinante e ingresso -> assinante.
  */
+#include "Notificador_Eventos.h"
+
+#include <iostream>
 #include <mutex>
 #include <condition_variable>
 
-NotificadorEventos::NotificadorEventos() 
-    : m_evento_ativo(false), m_tipo_atual(TipoEvento::NENHUM) {}
+NotificadorEventos::NotificadorEventos() = default;
 
 TipoEvento NotificadorEventos::esperar_evento() {
+    atr::Carimbo origem;
+    return esperar_evento(origem);
+}
+
+TipoEvento NotificadorEventos::esperar_evento(atr::Carimbo& origem) {
     std::unique_lock<std::mutex> lock(m_mutex);
     
     // Predicado protege contra 'spurious wakeups' (acordar sem sinal real)
-    m_cv.wait(lock, [this]{ return m_evento_ativo; });
-    
-    // Captura o evento e reseta o estado
-    TipoEvento evento_recebido = m_tipo_atual;
-    m_evento_ativo = false;
-    m_tipo_atual = TipoEvento::NENHUM;
-    
-    return evento_recebido;
+    m_cv.wait(lock, [this]{ return ha_pendente(); });
+    const Pendente p = retirar(lock);
+    origem = p.origem;
+    return p.tipo;
+}
+
+bool NotificadorEventos::esperar_evento_ate(std::chrono::steady_clock::time_point limite,
+                                            TipoEvento& tipo, atr::Carimbo& origem,
+                                            double* tempo_ate_falha_s) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_cv.wait_until(lock, limite, [this]{ return ha_pendente(); })) return false;
+    const Pendente p = retirar(lock);
+    tipo = p.tipo;
+    origem = p.origem;
+    if (tempo_ate_falha_s) *tempo_ate_falha_s = p.tempo_ate_falha_s;
+    return true;
+}
+
+NotificadorEventos::Pendente NotificadorEventos::retirar(std::unique_lock<std::mutex>& lock) {
+    Pendente p;
+    if (m_qtd > 0) {
+        // Captura o evento mais antigo e libera o slot
+        p = m_fila[m_inicio];
+        m_inicio = (m_inicio + 1) % CAPACIDADE;
+        --m_qtd;
+    } else {
+        // excedente: os tipos em ordem do enum, o do disparo mais recente por último
+        const std::uint32_t bit_ultimo = 1u << static_cast<unsigned>(m_ultimo_excedente);
+        const std::uint32_t outros = m_excedentes & ~bit_ultimo;
+        std::size_t t = static_cast<std::size_t>(m_ultimo_excedente);
+        if (outros != 0) {
+            t = 0;
+            while (!(outros & (1u << t))) ++t;
+        }
+        p = m_excedente[t];
+        m_excedentes &= ~(1u << t);
+    }
+    lock.unlock();
+
+    if (atr::ExportadorTrace::ativo()) {
+        const std::int64_t agora = atr::agora_ns();
+        atr::ExportadorTrace::intervalo("evento: disparo->assinante", p.caminhao, p.t_disparo_ns, agora, p.origem.seq);
+        atr::ExportadorTrace::intervalo("evento: mqtt->assinante", p.caminhao, p.origem.t_ingresso_ns, agora, p.origem.seq);
+    }
+    return p;
 }
 
-void NotificadorEventos::disparar_evento(TipoEvento tipo) {
+void NotificadorEventos::disparar_evento(TipoEvento tipo, const atr::Carimbo& origem, int caminhao,
+                                         double tempo_ate_falha_s) {
+    const Pendente novo{tipo, origem, atr::agora_ns(), caminhao, tempo_ate_falha_s};
+    bool estourou = false;
     {
-        // Bloqueia apenas o tempo suficiente para definir a flag
+        // Bloqueia apenas o tempo suficiente para enfileirar (nunca espera o assinante)
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_evento_ativo = true;
-        m_tipo_atual = tipo;
+        if (m_qtd < CAPACIDADE && m_excedentes == 0) {
+            m_fila[(m_inicio + m_qtd) % CAPACIDADE] = novo;
+            ++m_qtd;
+        } else {
+            // enquanto houver excedente, tudo vai para ele: preserva a ordem
+            estourou = (m_excedentes == 0);
+            const std::size_t t = static_cast<std::size_t>(tipo);
+            m_excedente[t] = novo;
+            m_excedentes |= 1u << t;
+            m_ultimo_excedente = tipo;
+        }
     }
-    // Notifica todas as threads interessadas (Logica, Controle, Coletor)
-    m_cv.notify_all();
-}
\ No newline at end of file
+    if (estourou) {
+        std::cerr << "[Notificador] fila de eventos cheia: disparos fundidos por tipo até o assinante esvaziar\n";
+    }
+    // Acorda quem espera (Lógica de Comando)
+    m_cv.notify_one();
+}
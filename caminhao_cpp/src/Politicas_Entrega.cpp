@@ -0,0 +1,102 @@
+/**
+ * @file Politicas_Entrega.cpp
+ * @brief Implementação da tabela de políticas de entrega por tópico.
+ */
+#include "Politicas_Entrega.h"
+#include "Roteador_Topicos.h"
+
+#include <iostream>
+#include <memory>
+
+namespace atr {
+
+namespace {
+
+// índice da rota = política; só lida depois de configurada no main
+std::unique_ptr<RoteadorTopicos> montar(const std::vector<RegraEntrega>& regras) {
+    auto tabela = std::make_unique<RoteadorTopicos>();
+    for (const auto& r : regras) {
+        tabela->registrar(r.filtro, nullptr, static_cast<int>(r.politica));
+    }
+    return tabela;
+}
+
+std::unique_ptr<RoteadorTopicos>& tabela() {
+    static std::unique_ptr<RoteadorTopicos> t = montar(politicas_padrao());
+    return t;
+}
+
+bool politica_de_texto(std::string_view nome, PoliticaEntrega& saida) {
+    if (nome == "ultimo")         { saida = PoliticaEntrega::ULTIMO_VALOR;   return true; }
+    if (nome == "melhor_esforco") { saida = PoliticaEntrega::MELHOR_ESFORCO; return true; }
+    if (nome == "confiavel")      { saida = PoliticaEntrega::CONFIAVEL;      return true; }
+    return false;
+}
+
+} // namespace
+
+std::vector<RegraEntrega> politicas_padrao() {
+    return {
+        // telemetria e setpoints: vale o dado mais novo
+        {"atr/+/sensor/raw",                   PoliticaEntrega::ULTIMO_VALOR},
+        {"atr/+/act",                          PoliticaEntrega::ULTIMO_VALOR},
+        {"atr/+/gestao/setpoint_posicao_final", PoliticaEntrega::ULTIMO_VALOR},
+        // logs: podem se perder, mas não se substituem
+        {"atr/+/planner/log",                  PoliticaEntrega::MELHOR_ESFORCO},
+        {"atr/+/sim/log",                      PoliticaEntrega::MELHOR_ESFORCO},
+        // comandos: entrega garantida, em ordem
+        {"atr/+/sim/cmd",                      PoliticaEntrega::CONFIAVEL},
+        {"atr/sim/#",                          PoliticaEntrega::CONFIAVEL},
+        // feed agregado da frota: cada delta depende do anterior
+        {"atr/frota/#",                        PoliticaEntrega::CONFIAVEL},
+        {"#",                                  PoliticaEntrega::CONFIAVEL},
+    };
+}
+
+void definir_politicas_entrega(const std::vector<RegraEntrega>& regras) {
+    tabela() = montar(regras);
+}
+
+bool politicas_de_texto(const std::string& texto, std::vector<RegraEntrega>& saida) {
+    std::string_view resto(texto);
+    while (!resto.empty()) {
+        const std::size_t fim = resto.find(';');
+        const std::string_view item = resto.substr(0, fim);
+        resto = (fim == std::string_view::npos) ? std::string_view() : resto.substr(fim + 1);
+        if (item.empty()) continue;
+
+        const std::size_t igual = item.find('=');
+        if (igual == std::string_view::npos || igual == 0) return false;
+        const std::string_view filtro = item.substr(0, igual);
+        if (!RoteadorTopicos::filtro_valido(filtro)) {
+            // a tabela ignoraria a regra em silêncio: recusa a variável inteira
+            std::cerr << "[Politicas] filtro MQTT inválido: '" << filtro << "'\n";
+            return false;
+        }
+        PoliticaEntrega p;
+        if (!politica_de_texto(item.substr(igual + 1), p)) return false;
+        saida.push_back({std::string(filtro), p});
+    }
+    return true;
+}
+
+PoliticaEntrega politica_do_topico(std::string_view topico) {
+    const RoteadorTopicos& t = *tabela();
+    const std::uint32_t id = t.resolver(topico);
+    return id == RoteadorTopicos::SEM_ROTA ? PoliticaEntrega::CONFIAVEL
+                                           : static_cast<PoliticaEntrega>(t.indice(id));
+}
+
+int qos_da_politica(PoliticaEntrega politica) {
+    return politica == PoliticaEntrega::CONFIAVEL ? 1 : 0;
+}
+
+int qos_do_topico(std::string_view topico) {
+    return qos_da_politica(politica_do_topico(topico));
+}
+
+Assinatura assinatura(const std::string& filtro) {
+    return {filtro, qos_do_topico(filtro)};
+}
+
+} // namespace atr
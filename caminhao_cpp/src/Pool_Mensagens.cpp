@@ -0,0 +1,133 @@
+/**
+ * @file Pool_Mensagens.cpp
+ * @brief Implementação da classe PoolMensagens.
+ *
+ * @objetivo Evitar malloc/free por mensagem entre as threads do Paho
+ * (produtoras) e as threads das tarefas (consumidoras).
+ *
+ * @mecanismo (Interno)
+ * - Estado: listas de mensagens livres e de blocos de controle livres,
+ *   protegidas por um mutex de seção curta (apenas push/pop de ponteiro).
+ * - AlocadorBloco: alocador usado pelo shared_ptr para o seu bloco de
+ *   controle; recicla blocos de tamanho fixo e mantém o Estado vivo.
+ * - Devolver: deleter que devolve a mensagem ao pool em vez de destruí-la.
+ */
+#include "Pool_Mensagens.h"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace atr {
+
+namespace {
+
+// o bloco de controle de shared_ptr(ptr, deleter, alocador) cabe com folga
+constexpr std::size_t TAM_BLOCO = 128;
+
+} // namespace
+
+struct PoolMensagens::Estado {
+    std::mutex mtx;
+    std::vector<MensagemMQTT*> livres;
+    std::vector<void*> blocos_livres;
+    std::vector<std::unique_ptr<MensagemMQTT>> todas;
+    std::size_t reserva_payload = 0;
+
+    ~Estado() {
+        for (void* b : blocos_livres) ::operator delete(b);
+    }
+};
+
+namespace {
+
+using Estado = PoolMensagens::Estado;
+
+template <typename T>
+struct AlocadorBloco {
+    using value_type = T;
+
+    // o alocador fica dentro do bloco de controle: mantém o Estado vivo
+    // até o próprio bloco ser devolvido
+    std::shared_ptr<Estado> estado;
+
+    explicit AlocadorBloco(std::shared_ptr<Estado> e) : estado(std::move(e)) {}
+
+    template <typename U>
+    AlocadorBloco(const AlocadorBloco<U>& outro) : estado(outro.estado) {}
+
+    T* allocate(std::size_t n) {
+        static_assert(sizeof(T) <= TAM_BLOCO, "bloco de controle maior que TAM_BLOCO");
+        if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T)));
+
+        {
+            std::lock_guard<std::mutex> lk(estado->mtx);
+            if (!estado->blocos_livres.empty()) {
+                void* b = estado->blocos_livres.back();
+                estado->blocos_livres.pop_back();
+                return static_cast<T*>(b);
+            }
+        }
+        return static_cast<T*>(::operator new(TAM_BLOCO));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        std::lock_guard<std::mutex> lk(estado->mtx);
+        estado->blocos_livres.push_back(p);
+    }
+
+    template <typename U>
+    bool operator==(const AlocadorBloco<U>& o) const { return estado == o.estado; }
+    template <typename U>
+    bool operator!=(const AlocadorBloco<U>& o) const { return estado != o.estado; }
+};
+
+struct Devolver {
+    Estado* estado; // vivo: o alocador do mesmo bloco de controle segura o Estado
+
+    void operator()(MensagemMQTT* msg) const {
+        std::lock_guard<std::mutex> lk(estado->mtx);
+        estado->livres.push_back(msg);
+    }
+};
+
+} // namespace
+
+PoolMensagens::PoolMensagens(std::size_t reserva_payload)
+    : m_estado(std::make_shared<Estado>())
+{
+    m_estado->reserva_payload = reserva_payload;
+}
+
+std::shared_ptr<MensagemMQTT> PoolMensagens::adquirir()
+{
+    MensagemMQTT* msg = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(m_estado->mtx);
+        if (!m_estado->livres.empty()) {
+            msg = m_estado->livres.back();
+            m_estado->livres.pop_back();
+        } else {
+            // aquecimento: cria uma mensagem nova e garante espaço para devolvê-la
+            m_estado->todas.push_back(std::make_unique<MensagemMQTT>());
+            msg = m_estado->todas.back().get();
+            msg->payload.reserve(m_estado->reserva_payload);
+            m_estado->livres.reserve(m_estado->todas.size());
+            m_estado->blocos_livres.reserve(m_estado->todas.size());
+        }
+    }
+    return std::shared_ptr<MensagemMQTT>(msg, Devolver{m_estado.get()},
+                                         AlocadorBloco<MensagemMQTT>(m_estado));
+}
+
+std::size_t PoolMensagens::criadas() const
+{
+    std::lock_guard<std::mutex> lk(m_estado->mtx);
+    return m_estado->todas.size();
+}
+
+} // namespace atr
@@ -0,0 +1,102 @@
+/**
+ * @file Previsao_Termica.cpp
+ * @brief Implementação da classe PrevisaoTermica.
+ *
+ * @entradas (Inputs)
+ * 1. atualizar(): amostras de temperatura (°C, s).
+ *
+ * @saidas (Outputs)
+ * 1. Tempo previsto até a temperatura atingir o limite (s).
+ */
+#include "Previsao_Termica.h"
+
+#include <cmath>
+
+namespace atr {
+
+namespace {
+
+constexpr double DT_MIN = 1e-3; // s: amostras com o mesmo instante
+
+// Um passo do filtro: só aritmética e seleções, sem desvios
+struct Passo {
+    double nivel, tendencia, variancia, tempo_ate_falha;
+};
+
+inline Passo passo(const ConfigPrevisao& c, double nivel, double tendencia, double variancia,
+                   double t_ultima, std::uint32_t amostras, double temp, double t_s)
+{
+    const bool primeira = (amostras == 0);
+    const double dt = std::fmax(t_s - t_ultima, DT_MIN);
+
+    const double a_nivel = dt / (c.tau_nivel_s + dt);
+    const double a_tend  = dt / (c.tau_tendencia_s + dt);
+
+    // Holt: prevê pelo nível + tendência e corrige pelo erro
+    const double previsto = nivel + tendencia * dt;
+    const double erro     = temp - previsto;
+    double n_nivel = previsto + a_nivel * erro;
+    double n_tend  = tendencia + a_tend * ((n_nivel - nivel) / dt - tendencia);
+    double n_var   = (1.0 - a_nivel) * (variancia + a_nivel * erro * erro);
+
+    // primeira amostra: só inicializa
+    n_nivel = primeira ? temp : n_nivel;
+    n_tend  = primeira ? 0.0 : n_tend;
+    n_var   = primeira ? 0.0 : n_var;
+
+    const double margem = c.limite - (n_nivel + c.sigmas * std::sqrt(n_var));
+    const bool sobe     = n_tend > c.inclinacao_min;
+    const bool aquecido = amostras + 1 >= c.min_amostras;
+    double tempo = sobe ? std::fmax(margem, 0.0) / n_tend : PrevisaoTermica::SEM_PREVISAO;
+    tempo = aquecido ? tempo : PrevisaoTermica::SEM_PREVISAO;
+
+    return {n_nivel, n_tend, n_var, tempo};
+}
+
+} // namespace
+
+PrevisaoTermica::PrevisaoTermica(const ConfigPrevisao& cfg)
+    : m_cfg(cfg)
+{}
+
+std::size_t PrevisaoTermica::adicionar()
+{
+    m_nivel.push_back(0.0);
+    m_tendencia.push_back(0.0);
+    m_variancia.push_back(0.0);
+    m_t_ultima.push_back(0.0);
+    m_amostras.push_back(0);
+    m_alertado.push_back(0);
+    return m_nivel.size() - 1;
+}
+
+double PrevisaoTermica::desvio(std::size_t i) const
+{
+    return std::sqrt(m_variancia[i]);
+}
+
+double PrevisaoTermica::atualizar(std::size_t i, double temp, double t_s)
+{
+    const Passo p = passo(m_cfg, m_nivel[i], m_tendencia[i], m_variancia[i],
+                          m_t_ultima[i], m_amostras[i], temp, t_s);
+    m_nivel[i]     = p.nivel;
+    m_tendencia[i] = p.tendencia;
+    m_variancia[i] = p.variancia;
+    m_t_ultima[i]  = t_s;
+    ++m_amostras[i];
+    return p.tempo_ate_falha;
+}
+
+bool PrevisaoTermica::novo_alerta(std::size_t i, double tempo_ate_falha)
+{
+    if (!m_alertado[i] && tempo_ate_falha < m_cfg.horizonte_s) {
+        m_alertado[i] = 1;
+        return true;
+    }
+    if (m_alertado[i] && tempo_ate_falha > 2.0 * m_cfg.horizonte_s) {
+        m_alertado[i] = 0;
+    }
+    return false;
+}
+
+} // namespace atr
@@ -0,0 +1,141 @@
+/**
+ * @file Rastreamento.cpp
+ * @brief Implementação do ExportadorTrace (Chrome Trace Event, JSON).
+ *
+ * @entradas (Inputs)
+ * 1. intervalo(): etapas registradas pelas tarefas.
+ *
+ * @saidas (Outputs)
+ * 1. Arquivo ATR_TRACE_ARQUIVO: eventos "X" (duração), um "processo"
+ *    por caminhão e uma "thread" (faixa) por etapa.
+ */
+#include "Rastreamento.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace atr {
+
+namespace {
+
+struct Intervalo {
+    const char* nome;
+    int caminhao;
+    std::int64_t inicio_ns;
+    std::int64_t fim_ns;
+    std::uint64_t seq;
+};
+
+// acima disso o gravador ficou para trás: descarta em vez de crescer sem limite
+constexpr std::size_t MAX_PENDENTES = 1 << 20;
+
+class Gravador {
+public:
+    explicit Gravador(std::FILE* arquivo) : m_arquivo(arquivo) {
+        std::fputs("[\n", m_arquivo);
+        m_thread = std::thread([this] { laco(); });
+        m_thread.detach(); // vive até o fim do processo, como as tarefas
+    }
+
+    void adicionar(const Intervalo& i) {
+        std::lock_guard<std::mutex> lk(m_mtx);
+        if (m_pendentes.size() >= MAX_PENDENTES) {
+            ++m_descartados;
+            return;
+        }
+        m_pendentes.push_back(i);
+    }
+
+private:
+    std::FILE* m_arquivo;
+    std::mutex m_mtx;
+    std::vector<Intervalo> m_pendentes;
+    std::uint64_t m_descartados = 0;
+    std::thread m_thread;
+
+    // só a thread do gravador usa
+    std::map<std::pair<int, const char*>, int> m_faixas; // (caminhão, etapa) -> tid
+
+    int faixa(int caminhao, const char* nome) {
+        const auto chave = std::make_pair(caminhao, nome);
+        auto it = m_faixas.find(chave);
+        if (it != m_faixas.end()) return it->second;
+
+        const int tid = static_cast<int>(m_faixas.size()) + 1;
+        m_faixas.emplace(chave, tid);
+        // metadados: nomes do "processo" (caminhão) e da faixa (etapa)
+        std::fprintf(m_arquivo,
+                     "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"caminhao %d\"}},\n"
+                     "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                     caminhao, caminhao, caminhao, tid, nome);
+        return tid;
+    }
+
+    void laco() {
+        std::vector<Intervalo> lote;
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            std::uint64_t descartados = 0;
+            {
+                std::lock_guard<std::mutex> lk(m_mtx);
+                lote.swap(m_pendentes);
+                descartados = m_descartados;
+                m_descartados = 0;
+            }
+            for (const Intervalo& i : lote) {
+                const int tid = faixa(i.caminhao, i.nome);
+                const std::int64_t dur = i.fim_ns > i.inicio_ns ? i.fim_ns - i.inicio_ns : 0;
+                std::fprintf(m_arquivo,
+                             "{\"name\":\"%s\",\"cat\":\"atr\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                             "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"seq\":%llu}},\n",
+                             i.nome, i.caminhao, tid, i.inicio_ns / 1000.0, dur / 1000.0,
+                             static_cast<unsigned long long>(i.seq));
+            }
+            lote.clear();
+            if (descartados > 0) {
+                std::cerr << "[Trace] " << descartados << " intervalos descartados (gravação atrasada)\n";
+            }
+            std::fflush(m_arquivo);
+        }
+    }
+};
+
+std::atomic<Gravador*> g_gravador{nullptr};
+
+} // namespace
+
+void ExportadorTrace::iniciar_do_ambiente() {
+    const char* caminho = std::getenv("ATR_TRACE_ARQUIVO");
+    if (!caminho || !*caminho || g_gravador.load()) return;
+
+    std::FILE* arquivo = std::fopen(caminho, "w");
+    if (!arquivo) {
+        std::cerr << "[Trace] não foi possível abrir " << caminho << "\n";
+        return;
+    }
+    g_gravador.store(new Gravador(arquivo)); // intencionalmente nunca destruído
+    std::cout << "[Trace] gravando intervalos em " << caminho << "\n";
+}
+
+bool ExportadorTrace::ativo() {
+    return g_gravador.load(std::memory_order_relaxed) != nullptr;
+}
+
+void ExportadorTrace::intervalo(const char* nome, int caminhao, std::int64_t inicio_ns,
+                                std::int64_t fim_ns, std::uint64_t seq) {
+    Gravador* g = g_gravador.load(std::memory_order_acquire);
+    if (!g || inicio_ns == 0) return;
+    g->adicionar({nome, caminhao, inicio_ns, fim_ns, seq});
+}
+
+} // namespace atr
@@ -0,0 +1,233 @@
+/**
+ * @file Roteador_Topicos.cpp
+ * @brief Implementação da classe RoteadorTopicos.
+ *
+ * @objetivo Trie de filtros MQTT por nível. O registro (internar/registrar)
+ * aloca; a resolução (resolver/para_cada/despachar) só percorre a trie
+ * com std::string_view e busca binária nos filhos de cada nó. Com
+ * curingas sobrepostos, a descida é uma busca em profundidade pelos
+ * ramos literal e '+' (ver o custo em Roteador_Topicos.h).
+ *
+ * @entradas (Inputs)
+ * 1. Filtros MQTT ("atr/1/sensor/raw", "atr/+/act", "atr/#").
+ * 2. Tópicos concretos das mensagens recebidas.
+ *
+ * @saidas (Outputs)
+ * 1. id da rota (+ índice do caminhão) ou chamada do tratador vinculado.
+ */
+#include "Roteador_Topicos.h"
+
+#include <algorithm>
+
+namespace atr {
+
+namespace {
+
+// Separa o primeiro nível de 'resto'. Se não houver '/', 'ultimo' = true.
+inline std::string_view proximo_nivel(std::string_view resto, std::string_view& depois, bool& ultimo)
+{
+    const std::size_t barra = resto.find('/');
+    ultimo = (barra == std::string_view::npos);
+    depois = ultimo ? std::string_view{} : resto.substr(barra + 1);
+    return resto.substr(0, barra);
+}
+
+} // namespace
+
+RoteadorTopicos::RoteadorTopicos() {
+    m_nos.emplace_back(); // raiz
+}
+
+// ---------------------------------------------------------------------
+// Registro
+// ---------------------------------------------------------------------
+
+bool RoteadorTopicos::filtro_valido(std::string_view filtro)
+{
+    if (filtro.empty()) return false;
+
+    std::string_view resto = filtro;
+    bool ultimo = false;
+    while (true) {
+        std::string_view depois;
+        const std::string_view nivel = proximo_nivel(resto, depois, ultimo);
+
+        if (nivel == "#") return ultimo;
+        if (nivel != "+" && nivel.find_first_of("+#") != std::string_view::npos) return false;
+
+        if (ultimo) return true;
+        resto = depois;
+    }
+}
+
+std::uint32_t RoteadorTopicos::filho_literal(std::uint32_t no, std::string_view nivel) const
+{
+    const auto& filhos = m_nos[no].filhos;
+    auto it = std::lower_bound(filhos.begin(), filhos.end(), nivel,
+        [](const Filho& f, std::string_view n) { return std::string_view(f.nivel) < n; });
+    if (it != filhos.end() && it->nivel == nivel) return it->no;
+    return SEM_ROTA;
+}
+
+std::uint32_t RoteadorTopicos::criar_filho(std::uint32_t no, std::string_view nivel)
+{
+    const std::uint32_t novo = static_cast<std::uint32_t>(m_nos.size());
+    m_nos.emplace_back();
+
+    auto& filhos = m_nos[no].filhos;
+    auto it = std::lower_bound(filhos.begin(), filhos.end(), nivel,
+        [](const Filho& f, std::string_view n) { return std::string_view(f.nivel) < n; });
+    filhos.insert(it, Filho{std::string(nivel), novo});
+    return novo;
+}
+
+std::uint32_t* RoteadorTopicos::slot_do_filtro(std::string_view filtro, bool criar)
+{
+    std::uint32_t no = 0;
+    std::string_view resto = filtro;
+    bool ultimo = false;
+
+    while (true) {
+        std::string_view depois;
+        const std::string_view nivel = proximo_nivel(resto, depois, ultimo);
+
+        if (nivel == "#") {
+            // '#' só é válido como último nível
+            return ultimo ? &m_nos[no].cerquilha : nullptr;
+        }
+
+        std::uint32_t prox;
+        if (nivel == "+") {
+            prox = m_nos[no].mais;
+            if (prox == SEM_ROTA) {
+                if (!criar) return nullptr;
+                prox = static_cast<std::uint32_t>(m_nos.size());
+                m_nos.emplace_back();
+                m_nos[no].mais = prox;
+            }
+        } else {
+            prox = filho_literal(no, nivel);
+            if (prox == SEM_ROTA) {
+                if (!criar) return nullptr;
+                prox = criar_filho(no, nivel);
+            }
+        }
+
+        no = prox;
+        if (ultimo) return &m_nos[no].rota;
+        resto = depois;
+    }
+}
+
+std::uint32_t RoteadorTopicos::internar(std::string_view filtro)
+{
+    if (!filtro_valido(filtro)) return SEM_ROTA;
+
+    std::uint32_t* slot = slot_do_filtro(filtro, true);
+    if (!slot) return SEM_ROTA;
+
+    if (*slot == SEM_ROTA) {
+        *slot = static_cast<std::uint32_t>(m_rotas.size());
+        m_rotas.push_back(Rota{std::string(filtro), nullptr, 0, false});
+    }
+    m_rotas[*slot].ativa = true;
+    return *slot;
+}
+
+std::uint32_t RoteadorTopicos::registrar(std::string_view filtro, Tratador tratador, int indice)
+{
+    const std::uint32_t id = internar(filtro);
+    if (id == SEM_ROTA) return SEM_ROTA;
+
+    m_rotas[id].tratador = std::move(tratador);
+    m_rotas[id].indice   = indice;
+    return id;
+}
+
+void RoteadorTopicos::remover(std::string_view filtro)
+{
+    std::uint32_t* slot = slot_do_filtro(filtro, false);
+    if (slot && *slot != SEM_ROTA) {
+        m_rotas[*slot].ativa = false;
+        m_rotas[*slot].tratador = nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------
+// Resolução (sem alocação)
+// ---------------------------------------------------------------------
+
+// Busca em profundidade: o ramo literal inteiro antes do '+', e o '#' do nó
+// por último, o que dá a prioridade literal > '+' > '#' nível a nível.
+std::uint32_t RoteadorTopicos::resolver_em(std::uint32_t no, std::string_view resto, bool primeiro) const
+{
+    std::string_view depois;
+    bool ultimo = false;
+    const std::string_view nivel = proximo_nivel(resto, depois, ultimo);
+
+    // tópicos de sistema ($SYS/...) não casam com curingas no primeiro nível
+    const bool sistema = primeiro && !nivel.empty() && nivel[0] == '$';
+
+    const std::uint32_t candidatos[2] = {
+        filho_literal(no, nivel),
+        sistema ? SEM_ROTA : m_nos[no].mais
+    };
+
+    for (std::uint32_t filho : candidatos) {
+        if (filho == SEM_ROTA) continue;
+        if (ultimo) {
+            if (rota_ativa(m_nos[filho].rota))      return m_nos[filho].rota;
+            if (rota_ativa(m_nos[filho].cerquilha)) return m_nos[filho].cerquilha; // "a/#" casa "a"
+        } else {
+            const std::uint32_t r = resolver_em(filho, depois, false);
+            if (r != SEM_ROTA) return r;
+        }
+    }
+
+    if (!sistema && rota_ativa(m_nos[no].cerquilha)) return m_nos[no].cerquilha;
+    return SEM_ROTA;
+}
+
+std::uint32_t RoteadorTopicos::resolver(std::string_view topico) const
+{
+    return resolver_em(0, topico, true);
+}
+
+void RoteadorTopicos::visitar_em(std::uint32_t no, std::string_view resto, bool primeiro,
+                                 void (*f)(void*, std::uint32_t), void* ctx) const
+{
+    std::string_view depois;
+    bool ultimo = false;
+    const std::string_view nivel = proximo_nivel(resto, depois, ultimo);
+
+    const bool sistema = primeiro && !nivel.empty() && nivel[0] == '$';
+
+    const std::uint32_t candidatos[2] = {
+        filho_literal(no, nivel),
+        sistema ? SEM_ROTA : m_nos[no].mais
+    };
+
+    for (std::uint32_t filho : candidatos) {
+        if (filho == SEM_ROTA) continue;
+        if (ultimo) {
+            if (rota_ativa(m_nos[filho].rota))      f(ctx, m_nos[filho].rota);
+            if (rota_ativa(m_nos[filho].cerquilha)) f(ctx, m_nos[filho].cerquilha);
+        } else {
+            visitar_em(filho, depois, false, f, ctx);
+        }
+    }
+
+    if (!sistema && rota_ativa(m_nos[no].cerquilha)) f(ctx, m_nos[no].cerquilha);
+}
+
+bool RoteadorTopicos::despachar(const MensagemMQTT& msg) const
+{
+    const std::uint32_t id = resolver(msg.topico);
+    // rota sem tratador engole a mensagem (sem recuo para curingas; ver .h)
+    if (id == SEM_ROTA || !m_rotas[id].tratador) return false;
+
+    m_rotas[id].tratador(msg, m_rotas[id].indice);
+    return true;
+}
+
+} // namespace atr
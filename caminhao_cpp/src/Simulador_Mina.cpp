@@ -0,0 +1,543 @@
+/**
+ * @file Simulador_Mina.cpp
+ * @brief Implementação da classe SimuladorMina.
+ *
+ * @objetivo Integrar a dinâmica de toda a frota a cada passo (DT = 1/hz)
+ * e publicar as amostras de sensor no mesmo formato do simulador Python.
+ *
+ * @entradas (Inputs)
+ * 1. atr/<id>/act      -> o_aceleracao (-100..100 %), o_direcao (graus)
+ * 2. atr/<id>/sim/cmd  -> set_noise, set_fault, clear_faults, temp_step,
+ *                         reset_position, stop
+ * 3. atr/sim/spawn     -> {"cmd":"spawn","truck_id":"<id>"}
+ * 4. atr/sim/remove    -> {"cmd":"remove","truck_id":"<id>" | ["<id>", ...]}
+ *
+ * @saidas (Outputs)
+ * 1. atr/<id>/sensor/raw -> JSON da amostra (posição, ângulo, temperatura, falhas)
+ * 2. atr/<id>/sim/log    -> texto
+ */
+#include "Simulador_Mina.h"
+#include "Json_Plano.h"
+#include "Politicas_Entrega.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace atr {
+
+namespace {
+
+// mesma dinâmica de interface_unificada/simulator_view.py
+constexpr double V_MAX = 2.0;  // velocidade máxima (unidades/s)
+constexpr double A_MAX = 2.0;  // aceleração máxima (unidades/s²)
+constexpr double FRIC  = 0.99; // atrito simples sobre a velocidade
+constexpr double PI    = 3.14159265358979323846;
+
+// abaixo disso, dividir a frota entre threads custa mais do que integra
+constexpr std::size_t MIN_POR_TRABALHADOR = 256;
+
+// round() do Python arredonda metade para o par, como nearbyint no modo padrão
+std::int64_t celula(double v) { return static_cast<std::int64_t>(std::nearbyint(v)); }
+
+double agora_epoch() {
+    using namespace std::chrono;
+    return duration<double>(system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// =====================================================================
+// Executor: threads fixas, um bloco contíguo da frota por trabalhador
+// =====================================================================
+
+class SimuladorMina::Executor {
+public:
+    using Trabalho = std::function<void(std::size_t ini, std::size_t fim, std::size_t trabalhador)>;
+
+    // estado por trabalhador (sem compartilhamento entre threads)
+    struct Local {
+        std::mt19937_64 rng;
+        std::string payload;
+    };
+
+    explicit Executor(std::size_t n) : m_locais(n ? n : 1) {
+        std::random_device rd;
+        for (auto& l : m_locais) {
+            l.rng.seed(rd());
+            l.payload.reserve(512);
+        }
+        // o trabalhador 0 é a própria thread do simulador
+        for (std::size_t w = 1; w < m_locais.size(); ++w) {
+            m_threads.emplace_back([this, w] { laco(w); });
+        }
+    }
+
+    ~Executor() {
+        {
+            std::lock_guard<std::mutex> lk(m_mtx);
+            m_encerrar = true;
+        }
+        m_cv_inicio.notify_all();
+        for (auto& t : m_threads) t.join();
+    }
+
+    std::size_t tamanho() const { return m_locais.size(); }
+    Local& local(std::size_t w) { return m_locais[w]; }
+
+    /** @brief Executa 'trabalho' sobre [0, total) dividido em blocos; retorna ao fim de todos. */
+    void paralelo(std::size_t total, const Trabalho& trabalho) {
+        const std::size_t n = std::min(m_locais.size(),
+                                       std::max<std::size_t>(1, total / MIN_POR_TRABALHADOR));
+        if (n == 1) {
+            trabalho(0, total, 0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(m_mtx);
+            m_trabalho = &trabalho;
+            m_total    = total;
+            m_ativos   = n;
+            m_pendentes = n - 1;
+            ++m_geracao;
+        }
+        m_cv_inicio.notify_all();
+
+        executar_bloco(0);
+
+        std::unique_lock<std::mutex> lk(m_mtx);
+        m_cv_fim.wait(lk, [this] { return m_pendentes == 0; });
+        m_trabalho = nullptr;
+    }
+
+private:
+    std::vector<Local> m_locais;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv_inicio;
+    std::condition_variable m_cv_fim;
+    const Trabalho* m_trabalho = nullptr;
+    std::size_t m_total = 0;
+    std::size_t m_ativos = 0;    // trabalhadores usados neste passo
+    std::size_t m_pendentes = 0; // trabalhadores (exceto o 0) ainda rodando
+    std::uint64_t m_geracao = 0;
+    bool m_encerrar = false;
+
+    void executar_bloco(std::size_t w) {
+        const std::size_t ini = m_total * w / m_ativos;
+        const std::size_t fim = m_total * (w + 1) / m_ativos;
+        (*m_trabalho)(ini, fim, w);
+    }
+
+    void laco(std::size_t w) {
+        std::uint64_t vista = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m_mtx);
+                m_cv_inicio.wait(lk, [&] { return m_encerrar || m_geracao != vista; });
+                if (m_encerrar) return;
+                vista = m_geracao;
+                if (w >= m_ativos) continue; // frota pequena: não participa deste passo
+            }
+            executar_bloco(w);
+            {
+                std::lock_guard<std::mutex> lk(m_mtx);
+                if (--m_pendentes != 0) continue;
+            }
+            m_cv_fim.notify_one();
+        }
+    }
+};
+
+// =====================================================================
+// SimuladorMina
+// =====================================================================
+
+SimuladorMina::SimuladorMina(ClienteMQTT& cliente, const ConfigSimulador& cfg)
+    : m_cli(cliente),
+      m_cfg(cfg),
+      m_dt(1.0 / (cfg.hz > 0.0 ? cfg.hz : 20.0))
+{
+    std::size_t n = cfg.threads ? cfg.threads : std::thread::hardware_concurrency();
+    m_exec = std::make_unique<Executor>(n ? n : 1);
+
+    m_rotas.registrar("atr/sim/spawn",
+                      [this](const MensagemMQTT& m, int) { tratar_spawn(m.payload); }, -1);
+    m_rotas.registrar("atr/sim/remove",
+                      [this](const MensagemMQTT& m, int) { tratar_remove(m.payload); }, -1);
+}
+
+SimuladorMina::~SimuladorMina() = default;
+
+void SimuladorMina::iniciar()
+{
+    m_cli.definir_callback([this](const MensagemPtr& msg) { receber(msg); });
+
+    // curingas: uma assinatura serve para a frota inteira, inclusive spawns futuros
+    m_cli.conectar_sessao({assinatura("atr/+/act"), assinatura("atr/+/sim/cmd"),
+                           assinatura("atr/sim/spawn"), assinatura("atr/sim/remove")},
+                          "Simulador");
+
+    std::cout << "[Simulador] " << m_exec->tamanho() << " threads, DT=" << m_dt << " s\n";
+}
+
+// ---------------------------------------------------------------------
+// Frota (só na thread do simulador)
+// ---------------------------------------------------------------------
+
+void SimuladorMina::registrar_rotas(std::size_t indice)
+{
+    const int i = static_cast<int>(indice);
+    const std::string& id = m_id[indice];
+    m_rotas.registrar("atr/" + id + "/act",
+                      [this](const MensagemMQTT& m, int idx) { aplicar_atuador(idx, m.payload); }, i);
+    m_rotas.registrar("atr/" + id + "/sim/cmd",
+                      [this](const MensagemMQTT& m, int idx) { aplicar_comando(idx, m.payload); }, i);
+}
+
+int SimuladorMina::indice_de(const std::string& id) const
+{
+    // a rota de atuadores do caminhão já guarda o índice: sem busca linear
+    const std::uint32_t rota = m_rotas.resolver("atr/" + id + "/act");
+    return rota == RoteadorTopicos::SEM_ROTA ? -1 : m_rotas.indice(rota);
+}
+
+bool SimuladorMina::adicionar_caminhao(const std::string& id)
+{
+    // o id vira nível de tópico: vazio ou com '/', '+', '#' não tem tópico próprio
+    if (id.empty() || id.find_first_of("/+#") != std::string::npos) return false;
+    if (indice_de(id) >= 0) return false;
+
+    m_id.push_back(id);
+    m_topico_sensor.push_back("atr/" + id + "/sensor/raw");
+    m_topico_log.push_back("atr/" + id + "/sim/log");
+    m_qos_sensor.push_back(static_cast<std::uint8_t>(qos_do_topico(m_topico_sensor.back())));
+    m_qos_log.push_back(static_cast<std::uint8_t>(qos_do_topico(m_topico_log.back())));
+    m_x.push_back(0.0);
+    m_y.push_back(0.0);
+    m_ang.push_back(0.0);
+    m_v.push_back(0.0);
+    m_temp.push_back(70.0);
+    m_o_acel.push_back(0.0);
+    m_o_dir.push_back(0.0);
+    m_sigma_pos.push_back(0.0);
+    m_sigma_ang.push_back(0.0);
+    m_sigma_temp.push_back(0.0);
+    m_f_eletrica.push_back(0);
+    m_f_hidraulica.push_back(0);
+    m_cel_x.push_back(0);
+    m_cel_y.push_back(0);
+    m_seq.push_back(0);
+
+    const std::size_t i = m_id.size() - 1;
+    m_caminhoes.store(m_id.size(), std::memory_order_relaxed);
+    registrar_rotas(i);
+    publicar_log(i, "caminhão " + id + ": criado");
+    return true;
+}
+
+bool SimuladorMina::remover_caminhao(const std::string& id)
+{
+    const int indice = indice_de(id);
+    if (indice < 0) return false;
+
+    const std::size_t i = static_cast<std::size_t>(indice);
+    const std::size_t ult = m_id.size() - 1;
+
+    publicar_log(i, "caminhão " + id + ": removido");
+    m_rotas.remover("atr/" + id + "/act");
+    m_rotas.remover("atr/" + id + "/sim/cmd");
+
+    // remove por troca com o último: O(1), mantém os vetores densos
+    auto trocar = [&](auto& v) {
+        if (i != ult) v[i] = std::move(v[ult]);
+        v.pop_back();
+    };
+    trocar(m_id); trocar(m_topico_sensor); trocar(m_topico_log);
+    trocar(m_qos_sensor); trocar(m_qos_log);
+    trocar(m_x); trocar(m_y); trocar(m_ang); trocar(m_v); trocar(m_temp);
+    trocar(m_o_acel); trocar(m_o_dir);
+    trocar(m_sigma_pos); trocar(m_sigma_ang); trocar(m_sigma_temp);
+    trocar(m_f_eletrica); trocar(m_f_hidraulica);
+    trocar(m_cel_x); trocar(m_cel_y); trocar(m_seq);
+
+    m_caminhoes.store(m_id.size(), std::memory_order_relaxed);
+    if (i != ult) registrar_rotas(i); // o antigo último mudou de índice
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Entrada: o callback só enfileira; o passo aplica
+// ---------------------------------------------------------------------
+
+void SimuladorMina::receber(const MensagemPtr& msg)
+{
+    std::lock_guard<std::mutex> lk(m_mtx_entrada);
+    m_entrada.push_back(msg);
+}
+
+void SimuladorMina::aplicar_entrada()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_mtx_entrada);
+        m_processando.swap(m_entrada);
+    }
+    for (const MensagemPtr& msg : m_processando) {
+        m_rotas.despachar(*msg); // id desconhecido: sem rota, ignorado
+    }
+    m_processando.clear();
+}
+
+void SimuladorMina::aplicar_atuador(int indice, const std::string& payload)
+{
+    const std::size_t i = static_cast<std::size_t>(indice);
+    double v;
+    if (json_numero(payload, "o_aceleracao", v)) m_o_acel[i] = v;
+    if (json_numero(payload, "o_direcao", v))    m_o_dir[i]  = v;
+}
+
+// Como o _on_cmd do Python, temp_step / reset_position / stop publicam a
+// amostra na hora, fora do passo. Roda em aplicar_entrada(), antes da
+// integração paralela: o estado do trabalhador 0 (esta thread) está livre.
+void SimuladorMina::aplicar_comando(int indice, const std::string& payload)
+{
+    const std::size_t i = static_cast<std::size_t>(indice);
+    try {
+        const json cmd = json::parse(payload);
+        const std::string c = cmd.value("cmd", std::string());
+        const std::string& id = m_id[i];
+
+        if (c == "set_noise") {
+            m_sigma_pos[i]  = cmd.value("sigma_pos", m_sigma_pos[i]);
+            m_sigma_ang[i]  = cmd.value("sigma_ang", m_sigma_ang[i]);
+            m_sigma_temp[i] = cmd.value("sigma_temp", m_sigma_temp[i]);
+        } else if (c == "set_fault") {
+            // como bool() do Python: aceita true/false ou número
+            auto verdadeiro = [](const json& j) {
+                return j.is_boolean() ? j.get<bool>() : j.get<double>() != 0.0;
+            };
+            if (cmd.contains("eletrica"))   m_f_eletrica[i]   = verdadeiro(cmd["eletrica"]);
+            if (cmd.contains("hidraulica")) m_f_hidraulica[i] = verdadeiro(cmd["hidraulica"]);
+        } else if (c == "clear_faults") {
+            m_f_eletrica[i]   = 0;
+            m_f_hidraulica[i] = 0;
+        } else if (c == "temp_step") {
+            m_temp[i] += cmd.value("delta", 0.0);
+            char txt[96];
+            std::snprintf(txt, sizeof(txt), ": temperatura %.1f°C", m_temp[i]);
+            publicar_log(i, "caminhão " + id + txt);
+            publicar_sensor(i, 0);
+        } else if (c == "reset_position") {
+            m_x[i]   = cmd.value("x", 0.0);
+            m_y[i]   = cmd.value("y", 0.0);
+            m_ang[i] = cmd.value("ang", 0.0);
+            m_v[i]   = 0.0;
+            m_o_acel[i] = 0.0;
+            m_o_dir[i]  = m_ang[i];
+            m_cel_x[i]  = celula(m_x[i]);
+            m_cel_y[i]  = celula(m_y[i]);
+            publicar_log(i, "caminhão " + id + ": posição (" + std::to_string(m_cel_x[i]) + "," +
+                            std::to_string(m_cel_y[i]) + ")");
+            publicar_sensor(i, 0);
+        } else if (c == "stop") {
+            m_o_acel[i] = 0.0;
+            m_v[i]      = 0.0;
+            publicar_log(i, "caminhão " + id + ": stop em (" + std::to_string(celula(m_x[i])) + "," +
+                            std::to_string(celula(m_y[i])) + ")");
+            publicar_sensor(i, 0);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Simulador CMD " << m_id[i] << "] erro: " << e.what() << "\n";
+    }
+}
+
+void SimuladorMina::tratar_spawn(const std::string& payload)
+{
+    try {
+        const json data = json::parse(payload);
+        if (data.value("cmd", std::string()) != "spawn" || !data.contains("truck_id")) return;
+
+        const json& tid = data["truck_id"];
+        const std::string id = tid.is_string() ? tid.get<std::string>() : tid.dump();
+        if (adicionar_caminhao(id)) return;
+        if (indice_de(id) < 0) {
+            std::cerr << "[Simulador SPAWN] id inválido para tópico: " << id << "\n";
+        } else {
+            const std::string topico = "atr/" + id + "/sim/log";
+            publicar(topico, "caminhão " + id + ": já existe", qos_do_topico(topico));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Simulador SPAWN] erro: " << e.what() << "\n";
+    }
+}
+
+void SimuladorMina::tratar_remove(const std::string& payload)
+{
+    try {
+        const json data = json::parse(payload);
+        if (data.value("cmd", std::string()) != "remove" || !data.contains("truck_id")) return;
+
+        auto remover = [this](const json& tid) {
+            remover_caminhao(tid.is_string() ? tid.get<std::string>() : tid.dump());
+        };
+        const json& tids = data["truck_id"];
+        if (tids.is_array()) {
+            for (const json& tid : tids) remover(tid);
+        } else {
+            remover(tids);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Simulador REMOVE] erro: " << e.what() << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------
+// Passo
+// ---------------------------------------------------------------------
+
+void SimuladorMina::passo()
+{
+    aplicar_entrada();
+
+    m_exec->paralelo(m_id.size(), [this](std::size_t ini, std::size_t fim, std::size_t w) {
+        integrar_bloco(ini, fim, w);
+    });
+    m_passos.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SimuladorMina::integrar_bloco(std::size_t ini, std::size_t fim, std::size_t trabalhador)
+{
+    const double dt = m_dt;
+    double* x = m_x.data();
+    double* y = m_y.data();
+    double* ang = m_ang.data();
+    double* v = m_v.data();
+    double* temp = m_temp.data();
+    const double* o_acel = m_o_acel.data();
+    const double* o_dir = m_o_dir.data();
+
+    // dinâmica: laço só com aritmética sobre os vetores
+    for (std::size_t i = ini; i < fim; ++i) {
+        const double a = std::clamp(o_acel[i] / 100.0 * A_MAX, -A_MAX, A_MAX);
+        const double vi = std::clamp((v[i] + a * dt) * FRIC, 0.0, V_MAX);
+        v[i] = vi;
+
+        // o_direcao é o ângulo absoluto do veículo, normalizado para [-180, 180]
+        double ai = o_dir[i];
+        if (ai > 180.0 || ai < -180.0) ai = std::remainder(ai, 360.0);
+        ang[i] = ai;
+
+        const double rad = ai * (PI / 180.0);
+        x[i] += vi * dt * std::cos(rad);
+        y[i] += vi * dt * std::sin(rad);
+
+        double ti = temp[i] + 0.01 * vi * dt; // aquece com a velocidade
+        if (vi < 0.1) ti -= 0.005 * dt;       // resfria parado
+        temp[i] = std::clamp(ti, -50.0, 200.0);
+    }
+
+    // publicação: por mudança de célula (como o Python) ou a cada passo
+    for (std::size_t i = ini; i < fim; ++i) {
+        const std::int64_t cx = celula(x[i]);
+        const std::int64_t cy = celula(y[i]);
+        const bool mudou = (cx != m_cel_x[i] || cy != m_cel_y[i]);
+        if (mudou) {
+            m_cel_x[i] = cx;
+            m_cel_y[i] = cy;
+            char txt[128];
+            std::snprintf(txt, sizeof(txt), " deslocando (%lld,%lld) , angulo: %.1f°",
+                          static_cast<long long>(cx), static_cast<long long>(cy), ang[i]);
+            publicar_log(i, "caminhão " + m_id[i] + txt);
+        }
+        if (mudou || m_cfg.publicar_todo_passo) {
+            publicar_sensor(i, trabalhador);
+        }
+    }
+}
+
+void SimuladorMina::publicar_sensor(std::size_t i, std::size_t trabalhador)
+{
+    Executor::Local& l = m_exec->local(trabalhador);
+    auto ruido = [&l](double sigma) {
+        return sigma > 0.0 ? std::normal_distribution<double>(0.0, sigma)(l.rng) : 0.0;
+    };
+
+    char buf[512];
+    const int n = std::snprintf(
+        buf, sizeof(buf),
+        ", \"seq\": %llu, \"ts\": %.6f, "
+        "\"i_posicao_x\": %.17g, \"i_posicao_y\": %.17g, \"i_angulo_x\": %.17g, "
+        "\"i_temperatura\": %.17g, \"i_falha_eletrica\": %s, \"i_falha_hidraulica\": %s, "
+        "\"dt\": %.17g}",
+        static_cast<unsigned long long>(m_seq[i]), agora_epoch(),
+        m_x[i] + ruido(m_sigma_pos[i]), m_y[i] + ruido(m_sigma_pos[i]),
+        m_ang[i] + ruido(m_sigma_ang[i]), m_temp[i] + ruido(m_sigma_temp[i]),
+        m_f_eletrica[i] ? "true" : "false", m_f_hidraulica[i] ? "true" : "false", m_dt);
+    if (n <= 0 || static_cast<std::size_t>(n) >= sizeof(buf)) return;
+
+    ++m_seq[i];
+    l.payload.assign("{\"truck_id\": ");
+    json_anexar_texto(l.payload, m_id[i]); // mesmo escape do agregador
+    l.payload.append(buf, static_cast<std::size_t>(n));
+    publicar(m_topico_sensor[i], l.payload, m_qos_sensor[i]);
+}
+
+void SimuladorMina::publicar_log(std::size_t i, const std::string& texto)
+{
+    publicar(m_topico_log[i], texto, m_qos_log[i]);
+}
+
+void SimuladorMina::publicar(const std::string& topico, const std::string& payload, int qos)
+{
+    try {
+        m_cli.publicar(topico, payload, qos);
+    } catch (const std::exception&) {
+        // broker fora durante a reconexão: a amostra se perde, a simulação segue
+        m_descartadas.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Laço principal
+// ---------------------------------------------------------------------
+
+void SimuladorMina::executar(const std::atomic<bool>& parar, double duracao_s)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::uint64_t limite =
+        duracao_s > 0.0 ? static_cast<std::uint64_t>(std::ceil(duracao_s / m_dt)) : 0;
+    const bool espera = m_cfg.fator_tempo > 0.0;
+    const auto periodo = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(espera ? m_dt / m_cfg.fator_tempo : 0.0));
+
+    std::uint64_t feitos = 0;
+    auto proximo = Clock::now();
+    while (!parar.load(std::memory_order_relaxed) && (limite == 0 || feitos < limite)) {
+        passo();
+        ++feitos;
+
+        if (espera) {
+            // cadência fixa; se atrasar, não tenta recuperar em rajada
+            proximo += periodo;
+            const auto agora = Clock::now();
+            if (proximo > agora) {
+                std::this_thread::sleep_until(proximo);
+            } else {
+                proximo = agora;
+            }
+        }
+    }
+}
+
+} // namespace atr
@@ -4,16 +4,55 @@
  *
  * Responsabilidades:
  * 1. Instanciar objetos de estado compartilhado (BufferCircular, NotificadorEventos).
- * 2. Criar e lançar as 6 threads de tarefas principais.
+ * 2. Criar e lançar as 6 threads de tarefas principais (e a de consulta do histórico).
  * 3. Passar referências às threads.
  * 4. Manter o processo vivo (join nas threads).
  */
 
+#include "Buffer_Circular.h"
+#include "Cliente_MQTT.h"
+#include "Historico_Trajetoria.h"
+#include "Marcos_Inicializacao.h"
+#include "Notificador_Eventos.h"
+#include "Politicas_Entrega.h"
+#include "Rastreamento.h"
+#include "Simulador_Mina.h"
+#include "tarefas.h"
+
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <string>
+#include <vector>
+
+namespace {
+
+// Simulador em processo (ATR_SIM_CAMINHOES): gera a carga de sensores sem o
+// simulador Python. Com ATR_MQTT_TRANSPORTE=local, roda sem broker nem rede.
+void rodar_simulador(int primeiro_id, int caminhoes, double fator) {
+    auto cli = atr::criar_cliente_mqtt(atr::uri_broker(), "sim_embutido_" + std::to_string(primeiro_id));
+    atr::ConfigSimulador cfg;
+    cfg.fator_tempo = fator;
+    atr::SimuladorMina sim(*cli, cfg);
+    sim.iniciar();
+    for (int k = 0; k < caminhoes; ++k) {
+        sim.adicionar_caminhao(std::to_string(primeiro_id + k));
+    }
+
+    std::atomic<bool> nunca{false};
+    sim.executar(nunca);
+}
+
+} // namespace
 
 int main(int argc, char* argv[]) {
+    // origem da medição do tempo até a primeira amostra processada
+    atr::marcar_inicio_processo();
+    // ATR_TRACE_ARQUIVO: intervalos por etapa (MQTT -> buffer -> setpoint / evento)
+    atr::ExportadorTrace::iniciar_do_ambiente();
+
     // 1) Lê ID do caminhão (opcional). Se não vier, usa 1 para não falhar no Docker.
     int caminhao_id = 1;
     if (argc >= 2) {
@@ -29,11 +68,51 @@ int main(int argc, char* argv[]) {
 
     std::cout << "--- Iniciando Caminhao Embarcado ID: " << caminhao_id << " ---\n";
 
-    BufferCircular buffer_principal;
+    // 2) Transporte MQTT: "paho" (padrão, broker real) ou "local" (broker em processo)
+    if (const char* transporte = std::getenv("ATR_MQTT_TRANSPORTE")) {
+        atr::TransporteMQTT t;
+        if (atr::transporte_de_texto(transporte, t)) {
+            atr::definir_transporte_mqtt(t);
+            std::cout << "[Main] Transporte MQTT: " << transporte << "\n";
+        } else {
+            std::cerr << "[Main] ATR_MQTT_TRANSPORTE inválido (" << transporte << "). Usando paho.\n";
+        }
+    }
+
+    // 3) Política de entrega por tópico (QoS / último valor): padrão + ATR_QOS_POLITICAS
+    if (const char* politicas = std::getenv("ATR_QOS_POLITICAS")) {
+        std::vector<atr::RegraEntrega> regras = atr::politicas_padrao();
+        if (atr::politicas_de_texto(politicas, regras)) {
+            atr::definir_politicas_entrega(regras);
+            std::cout << "[Main] Políticas de entrega: " << politicas << "\n";
+        } else {
+            std::cerr << "[Main] ATR_QOS_POLITICAS inválido (" << politicas << "). Usando o padrão.\n";
+        }
+    }
+
+    // 4) Histórico: capacidade do buffer bruto e janelas dos agregados (ATR_HISTORICO_*)
+    const ConfigHistorico cfg_historico = ConfigHistorico::do_ambiente();
+
+    BufferCircular buffer_principal(cfg_historico.capacidade_bruta());
+    HistoricoTrajetoria historico(buffer_principal, cfg_historico);
     NotificadorEventos notificador_falhas;
 
     // vincula buffer + id para a tarefa de sensores (IMPLEMENTAÇÃO EXISTENTE)
-    atr::tratamento_sensores(&buffer_principal, caminhao_id);
+    atr::tratamento_sensores(&buffer_principal, caminhao_id, &historico);
+
+    // 5) Carga sintética (opcional): ATR_SIM_CAMINHOES=N simula os caminhões
+    //    id..id+N-1; os extras também são vinculados ao Tratamento de Sensores.
+    //    ATR_SIM_FATOR: 1 = tempo real (padrão), 0 = sem espera.
+    int sim_caminhoes = 0;
+    double sim_fator = 1.0;
+    if (const char* n = std::getenv("ATR_SIM_CAMINHOES")) sim_caminhoes = std::atoi(n);
+    if (const char* f = std::getenv("ATR_SIM_FATOR")) sim_fator = std::atof(f);
+
+    std::vector<std::unique_ptr<BufferCircular>> buffers_extras;
+    for (int k = 1; k < sim_caminhoes; ++k) {
+        buffers_extras.push_back(std::make_unique<BufferCircular>(cfg_historico.capacidade_bruta()));
+        atr::tratamento_sensores(buffers_extras.back().get(), caminhao_id + k);
+    }
 
     // cria a thread da tarefa de sensores (IMPLEMENTAÇÃO EXISTENTE)
     std::thread t_sens(atr::tarefa_tratamento_sensores_run, std::string("localhost"));
@@ -44,16 +123,25 @@ int main(int argc, char* argv[]) {
     std::thread t_coletor(atr::tarefa_coletor_dados, caminhao_id, std::ref(buffer_principal), std::ref(notificador_falhas));
     std::thread t_navegacao(atr::tarefa_controle_navegacao, caminhao_id, std::ref(buffer_principal), std::ref(notificador_falhas));
     std::thread t_planejamento(atr::tarefa_planejamento_rota, caminhao_id, std::ref(buffer_principal));
+    // trajetória sob demanda para a interface e a gestão (pedido/resposta MQTT)
+    std::thread t_historico(atr::tarefa_consulta_historico, caminhao_id, std::cref(historico));
 
-    std::cout << "[Main " << caminhao_id << "] 6 threads de tarefas iniciadas.\n";
+    // as tarefas conectam em paralelo, cada uma na sua thread (com retentativas)
+    atr::registrar_marco("Main " + std::to_string(caminhao_id) + ": 7 threads de tarefas iniciadas");
+
+    if (sim_caminhoes > 0) {
+        std::thread(rodar_simulador, caminhao_id, sim_caminhoes, sim_fator).detach();
+        std::cout << "[Main " << caminhao_id << "] Simulador embutido: " << sim_caminhoes << " caminhões.\n";
+    }
 
-    // 4) Espera as threads
+    // 6) Espera as threads
     t_sens.join();
     t_monitor_falhas.join();
     t_logica_comando.join();
     t_coletor.join();
     t_navegacao.join();
     t_planejamento.join();
+    t_historico.join();
 
     std::cout << "[Main " << caminhao_id << "] Processo encerrado.\n";
     return 0;
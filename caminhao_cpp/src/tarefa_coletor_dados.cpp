@@ -9,10 +9,10 @@
  * 3. Enviar o estado atual do caminhão de volta para a Interface Local (via IPC).
  *
  * @entradas (Inputs)
- * 1. Buffer Circular (leitura): Lê "e_defeito", "e_automatico", "i_pos_x", 
+ * 1. Buffer Circular (leitura): Lê "e_defeito", "e_automatico" (modo
+ * atômico publicado pela Lógica de Comando, sem lock), "i_pos_x",
  * "i_pos_y", "i_angulo_x".
- * 2. Notificador de Eventos (recebimento): Recebe eventos de falha.
- * 3. IPC (recebimento): Recebe comandos da Interface Local 
+ * 2. IPC (recebimento): Recebe comandos da Interface Local 
  * (ex: "c_automatico", "c_man", "c_rearme").
  *
  * @saidas (Outputs)
@@ -22,6 +22,13 @@
  * 3. IPC (envio): Envia dados de estado (posição, falhas, modo) 
  * para a Interface Local.
  */
+#include "Buffer_Circular.h"
+#include "IPC_Manager.h"
+#include "Maquina_Estados.h"
+#include "Notificador_Eventos.h"
+#include "tarefas.h"
+
+#include <cstdio>
 #include <string>
 #include <iostream>
 #include <chrono>
@@ -29,11 +36,40 @@
 
 namespace atr {
 
-void tarefa_coletor_dados(int id, BufferCircular& buffer, NotificadorEventos& notificador) {
+void tarefa_coletor_dados(int id, BufferCircular& buffer, NotificadorEventos& /*notificador*/) {
     std::cout << "[Coletor " << id << "] Thread iniciada." << std::endl;
-    while(true) {
-        // Lógica (vazia)
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    IpcManager ipc(id);
+    ModoOperacao modo_anterior = buffer.get_modo();
+    char estado[160];
+
+    while (true) {
+        // comandos do operador -> Lógica de Comando
+        for (std::string txt = ipc.receber_comando(); !txt.empty(); txt = ipc.receber_comando()) {
+            ComandoOperador cmd;
+            if (!comando_de_texto(txt, cmd)) {
+                std::cerr << "[Coletor " << id << "] comando desconhecido: " << txt << "\n";
+            } else if (!buffer.enviar_comando(cmd)) {
+                std::cerr << "[Coletor " << id << "] fila de comandos cheia: " << txt << " descartado\n";
+            }
+        }
+
+        // estado -> interface local
+        const ModoOperacao modo = buffer.get_modo();
+        if (modo != modo_anterior) {
+            std::cout << "[Coletor " << id << "] modo: " << nome_modo(modo_anterior)
+                      << " -> " << nome_modo(modo) << "\n";
+            modo_anterior = modo;
+        }
+        const BufferCircular::PosicaoData pos = buffer.get_posicao_recente();
+        std::snprintf(estado, sizeof(estado),
+                      "{\"i_pos_x\":%.2f,\"i_pos_y\":%.2f,\"i_angulo_x\":%.1f,"
+                      "\"e_defeito\":%d,\"e_automatico\":%d}",
+                      pos.i_pos_x, pos.i_pos_y, pos.i_angulo_x,
+                      modo == ModoOperacao::DEFEITO, modo == ModoOperacao::AUTOMATICO);
+        ipc.enviar_estado(estado);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 }
 
@@ -0,0 +1,156 @@
+/**
+ * @file tarefa_consulta_historico.cpp
+ * @brief Implementação da thread Consulta do Histórico.
+ *
+ * @objetivo Servir a trajetória guardada pelo HistoricoTrajetoria para a
+ * interface local e a gestão, por pedido/resposta MQTT, sem que elas
+ * precisem assinar a telemetria bruta ou reprocessar os logs do coletor.
+ *
+ * @entradas (Inputs)
+ * 1. MQTT (subscribe): atr/<id>/historico/consulta
+ *      {"janela_s": 3600, "max": 500, "pedido": 7}
+ *    "max" (padrão 1000, limitado a 4000 pontos) e "pedido" (número
+ *    devolvido na resposta, para casar pedido e resposta) são opcionais.
+ *
+ * @saidas (Outputs)
+ * 1. MQTT (publish): atr/<id>/historico/resposta
+ *      {"pedido":7,"nivel":"1s","t":<s epoch da resposta>,"pontos":[
+ *        {"t":-3599.00,"d":1,"n":20,"x":[min,max,media],"y":[min,max,media],"ang":90.0},
+ *        ..., {..., "aberto":true}]}
+ *    "t" de cada ponto é o início do intervalo, em segundos antes da
+ *    resposta; "d" é a duração (0 nas amostras brutas). Nos níveis "1s" e
+ *    "10s", o último ponto é o intervalo em aberto ("aberto":true).
+ *    Pedido inválido: {"pedido":7,"erro":"..."}. Um "pedido" fora de
+ *    [-2^53, 2^53] não é ecoado: a resposta é {"erro":"pedido invalido"}.
+ *
+ * @mecanismo (Interno)
+ * O vetor de pontos e o texto da resposta são reservados na partida e
+ * reaproveitados: em regime, atender um pedido não aloca nesta thread.
+ */
+#include "Cliente_MQTT.h"
+#include "Historico_Trajetoria.h"
+#include "Json_Plano.h"
+#include "Politicas_Entrega.h"
+#include "tarefas.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace atr {
+
+namespace {
+
+constexpr std::size_t MAX_PONTOS    = 4000; // 1 h de agregados de 1 s cabe inteira
+constexpr std::size_t PONTOS_PADRAO = 1000;
+constexpr double      MAX_PEDIDO    = 9007199254740992.0; // 2^53: inteiros exatos em double, "%.0f" cabe em 17 dígitos
+
+const char* nome_nivel(HistoricoTrajetoria::Nivel nivel) {
+    switch (nivel) {
+        case HistoricoTrajetoria::Nivel::BRUTO: return "bruto";
+        case HistoricoTrajetoria::Nivel::SEG_1: return "1s";
+        default:                                return "10s";
+    }
+}
+
+double agora_epoch() {
+    using namespace std::chrono;
+    return duration<double>(system_clock::now().time_since_epoch()).count();
+}
+
+void abrir_resposta(std::string& saida, bool com_pedido, double pedido) {
+    char tmp[48];
+    saida = "{";
+    if (com_pedido) {
+        std::snprintf(tmp, sizeof(tmp), "\"pedido\":%.0f,", pedido);
+        saida += tmp;
+    }
+}
+
+void montar_resposta(std::string& saida, bool com_pedido, double pedido, HistoricoTrajetoria::Nivel nivel,
+                     const HistoricoTrajetoria::Agregado* pontos, std::size_t n, double agora_s)
+{
+    char tmp[256];
+    abrir_resposta(saida, com_pedido, pedido);
+    std::snprintf(tmp, sizeof(tmp), "\"nivel\":\"%s\",\"t\":%.3f,\"pontos\":[", nome_nivel(nivel), agora_epoch());
+    saida += tmp;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const HistoricoTrajetoria::Agregado& p = pontos[i];
+        std::snprintf(tmp, sizeof(tmp),
+                      "%s{\"t\":%.2f,\"d\":%g,\"n\":%u,\"x\":[%.2f,%.2f,%.2f],\"y\":[%.2f,%.2f,%.2f],"
+                      "\"ang\":%.1f%s}",
+                      i ? "," : "", p.t_inicio - agora_s, p.duracao, p.n,
+                      p.x.min, p.x.max, p.x.media, p.y.min, p.y.max, p.y.media,
+                      p.ang_medio, p.aberto ? ",\"aberto\":true" : "");
+        saida += tmp;
+    }
+    saida += "]}";
+}
+
+void montar_erro(std::string& saida, bool com_pedido, double pedido, const char* erro) {
+    abrir_resposta(saida, com_pedido, pedido);
+    saida += "\"erro\":\"";
+    saida += erro;
+    saida += "\"}";
+}
+
+} // namespace
+
+void tarefa_consulta_historico(int id, const HistoricoTrajetoria& historico) {
+    std::cout << "[Historico " << id << "] Thread iniciada.\n";
+
+    const std::string topico_consulta = "atr/" + std::to_string(id) + "/historico/consulta";
+    const std::string topico_resposta = "atr/" + std::to_string(id) + "/historico/resposta";
+    const int qos_resposta = qos_do_topico(topico_resposta);
+
+    auto cli = criar_cliente_mqtt(uri_broker("localhost"), "historico_" + std::to_string(id));
+    cli->iniciar_consumo();
+    cli->conectar_sessao({assinatura(topico_consulta)}, "Histórico " + std::to_string(id));
+    std::cout << "[Historico " << id << "] Atendendo " << topico_consulta << "\n";
+
+    std::vector<HistoricoTrajetoria::Agregado> pontos(MAX_PONTOS);
+    std::string resposta;
+    resposta.reserve(MAX_PONTOS * 128);
+
+    while (true) {
+        MensagemPtr msg = cli->consumir();
+        if (!msg) continue;
+
+        double pedido = 0.0;
+        const bool tem_pedido = json_numero(msg->payload, "pedido", pedido);
+        // NaN/inf e magnitudes enormes (1e300) não viram texto na resposta
+        const bool pedido_valido = !tem_pedido || std::fabs(pedido) <= MAX_PEDIDO;
+        const bool com_pedido = tem_pedido && pedido_valido;
+
+        double janela_s = 0.0;
+        double maximo = static_cast<double>(PONTOS_PADRAO);
+        if (!pedido_valido) {
+            montar_erro(resposta, false, 0.0, "pedido invalido");
+        } else if (!json_numero(msg->payload, "janela_s", janela_s) || !std::isfinite(janela_s) || janela_s <= 0.0) {
+            montar_erro(resposta, com_pedido, pedido, "janela_s ausente ou invalida");
+        } else {
+            json_numero(msg->payload, "max", maximo);
+            const std::size_t n_max = !(maximo >= 1.0) ? 1
+                                    : maximo >= static_cast<double>(MAX_PONTOS) ? MAX_PONTOS
+                                    : static_cast<std::size_t>(maximo);
+
+            HistoricoTrajetoria::Nivel nivel;
+            const std::size_t n = historico.consultar(janela_s, pontos.data(), n_max, &nivel);
+            montar_resposta(resposta, com_pedido, pedido, nivel, pontos.data(), n,
+                            historico.segundos(HistoricoTrajetoria::Clock::now()));
+        }
+
+        try {
+            cli->publicar(topico_resposta, resposta, qos_resposta, false);
+        } catch (const std::exception& e) {
+            // reconectando: quem pediu repete o pedido
+            std::cerr << "[Historico " << id << "] resposta não publicada: " << e.what() << "\n";
+        }
+    }
+}
+
+} // namespace atr
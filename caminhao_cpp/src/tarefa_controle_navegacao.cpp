@@ -9,15 +9,18 @@
  * 3. (Defeito): Não executa movimentação e aguarda o rearme.
  *
  * @entradas (Inputs)
- * 1. Buffer Circular (leitura): Lê os estados "e_defeito", "e_automatico"
- * e os setpoints "setpoint_velocidade", "setpoint_posicao_angular".
- * 2. Notificador de Eventos (recebimento): Recebe eventos de falha 
- * disparados pelo Monitoramento de Falhas.
+ * 1. Buffer Circular (leitura): Lê o modo ("e_defeito", "e_automatico",
+ * atômico publicado pela Lógica de Comando, sem lock), as posições e os
+ * setpoints "setpoint_velocidade", "setpoint_posicao_angular".
  *
  * @saidas (Outputs)
  * 1. Buffer Circular (escrita): Escreve as variáveis de controle 
  * calculadas "velocidade" e "posicao_angular".
  */
+#include "Buffer_Circular.h"
+#include "Notificador_Eventos.h"
+#include "tarefas.h"
+
 #include <string>
 #include <iostream>
 #include <chrono>
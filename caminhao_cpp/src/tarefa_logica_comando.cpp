@@ -11,17 +11,30 @@
  *
  * @entradas (Inputs)
  * 1. Buffer Circular (leitura): Lê os dados de posição, os comandos do 
- * operador (ex: "c_man", "c_acelera") e os valores de controle 
- * (ex: "velocidade").
+ * operador (ex: "c_man", "c_automatico", "c_rearme") e os valores de
+ * controle (ex: "velocidade").
  * 2. Notificador de Eventos (recebimento): Recebe eventos de falha 
  * disparados pelo Monitoramento de Falhas.
  *
  * @saidas (Outputs)
  * 1. Buffer Circular (escrita): Escreve os estados atuais do 
- * caminhão: "e_defeito" e "e_automatico".
+ * caminhão: "e_defeito" e "e_automatico" (modo atômico).
  * 2. MQTT (publish): Publica os comandos finais dos atuadores 
  * "o_aceleracao" e "o_direcao".
+ *
+ * @mecanismo (Interno)
+ * Ciclo de 50 ms. Entre ciclos, a thread dorme no Notificador: um evento
+ * de falha é aplicado na MaquinaEstados (tabela gerada em tempo de
+ * compilação) e, se o modo mudar, o novo modo é publicado na hora, sem
+ * esperar o fim do ciclo. A cada ciclo: comandos do operador e modo
+ * publicado.
  */
+#include "Buffer_Circular.h"
+#include "Maquina_Estados.h"
+#include "Notificador_Eventos.h"
+#include "Rastreamento.h"
+#include "tarefas.h"
+
 #include <string> 
 #include <iostream>
 #include <chrono>
@@ -29,11 +42,43 @@
 
 namespace atr {
 
+namespace {
+
+constexpr auto PERIODO_LOGICA = std::chrono::milliseconds(50); // ~20 Hz
+
+} // namespace
+
 void tarefa_logica_comando(int id, BufferCircular& buffer, NotificadorEventos& notificador) {
     std::cout << "[Logica " << id << "] Thread iniciada." << std::endl;
-    while(true) {
-        // Lógica (vazia)
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    MaquinaEstados maquina;
+    buffer.set_modo(maquina.modo());
+
+    auto aplicar_modo = [&] {
+        buffer.set_modo(maquina.modo());
+        std::cout << "[Logica " << id << "] Modo: " << nome_modo(maquina.modo()) << "\n";
+    };
+
+    auto proximo_ciclo = std::chrono::steady_clock::now() + PERIODO_LOGICA;
+    while (true) {
+        TipoEvento evento;
+        Carimbo origem;
+        double tempo_ate_falha = 0.0;
+        if (notificador.esperar_evento_ate(proximo_ciclo, evento, origem, &tempo_ate_falha)) {
+            if (evento == TipoEvento::ALERTA_PREDITIVO) {
+                // não muda o modo: só avisa o operador antes do defeito
+                std::cout << "[Logica " << id << "] Alerta preditivo: defeito térmico previsto em ~"
+                          << static_cast<long>(tempo_ate_falha) << " s\n";
+            }
+            if (maquina.aplicar(evento)) aplicar_modo(); // reação imediata à falha
+            continue;
+        }
+
+        bool mudou = false;
+        buffer.retirar_comandos([&](ComandoOperador cmd) { mudou |= maquina.aplicar(cmd); });
+        if (mudou) aplicar_modo();
+
+        proximo_ciclo += PERIODO_LOGICA;
     }
 }
 
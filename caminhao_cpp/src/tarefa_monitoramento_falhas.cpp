@@ -7,24 +7,51 @@
  * temperatura) e disparar eventos de falha/alerta para as outras tarefas.
  *
  * @entradas (Inputs)
- * 1. MQTT (subscribe): Assina os tópicos:
- *      caminhao/<id>/sensores/i_temperatura
- *      caminhao/<id>/sensores/i_falha_hidraulica
- *      caminhao/<id>/sensores/i_falha_eletrica
+ * 1. MQTT (subscribe): atr/<id>/sensor/raw, a mesma amostra que o
+ *    simulador publica (campos i_temperatura, i_falha_eletrica e
+ *    i_falha_hidraulica). Política ULTIMO_VALOR: as falhas são estados,
+ *    e a amostra mais nova basta.
  *
  * @saidas (Outputs)
  * 1. Notificador de Eventos (disparo): Dispara eventos 
  *    (ex: "alerta_termico", "falha_termica", "falha_eletrica",
- *     "falha_hidraulica", "falha_sensor_timeout", "normalizacao").
+ *     "falha_hidraulica", "falha_sensor_timeout", "alerta_preditivo",
+ *     "normalizacao"), com o carimbo (sequência + chegada MQTT) da
+ *    leitura que os gerou.
+ *
+ * NORMALIZACAO só sai quando nenhuma falha continua ativa (máscara
+ * m_defeitos): com duas falhas simultâneas, a normalização da primeira
+ * não libera o rearme na Lógica de Comando.
+ *
+ * Além dos limiares fixos, a temperatura passa pela PrevisaoTermica
+ * (nível, tendência e variância incrementais): se a tendência projeta
+ * falha_on dentro do horizonte, dispara ALERTA_PREDITIVO com o tempo
+ * previsto até a falha, antes de o defeito acontecer.
+ *
+ * O watchdog de sensores (FALHA_SENSOR_TIMEOUT) só arma depois da
+ * primeira amostra e só se FaultConfig::timeout > 0.
  */
+#include "Cliente_MQTT.h"
+#include "Config_Falhas.h"
+#include "Json_Plano.h"
+#include "Marcos_Inicializacao.h"
+#include "Notificador_Eventos.h"
+#include "Politicas_Entrega.h"
+#include "Previsao_Termica.h"
+#include "Rastreamento.h"
+#include "Roteador_Topicos.h"
+
+#include <cstdint>
+#include <cstdlib>
 #include <string>
-#include <mqtt/async_client.h>
+#include <memory>
 #include <chrono>
+#include <cmath>
 #include <string>
 #include <iostream>
 #include <string>
 
-const std::string BROKER_ADRESS = "tcp://localhost:1883";
+const std::string BROKER_ADDRESS = "localhost";
 const int BROKER_PORT = 1883;
 
 namespace atr {
@@ -33,14 +60,7 @@ using Clock      = std::chrono::steady_clock;
 using TimePoint  = std::chrono::steady_clock::time_point;
 using namespace std::chrono_literals;
 
-// Configurações de histerese e timeout (mesma lógica do código original)
-struct FaultConfig {
-    int alerta_on  = 95;    // sobe alerta térmico
-    int alerta_off = 90;    // desce alerta térmico
-    int falha_on   = 120;   // sobe falha térmica
-    int falha_off  = 115;   // desce falha térmica
-    std::chrono::milliseconds timeout{1000}; // timeout de sensores
-};
+// Configurações de histerese e timeout: FaultConfig (Config_Falhas.h)
 
 class MonitorMQTT {
 public:
@@ -48,48 +68,32 @@ public:
         : m_id(id),
           m_notif(notificador),
           m_cfg(cfg),
+          m_previsao(ConfigPrevisao{static_cast<double>(cfg.falha_on)}),
           m_server_uri(build_server_uri()),
-          m_client(m_server_uri, "monitor_" + std::to_string(id))
+          m_client(criar_cliente_mqtt(m_server_uri, "monitor_" + std::to_string(id)))
     {
-        // Monta tópicos conforme comentário original
-        std::string base = "caminhao/" + std::to_string(m_id) + "/sensores/";
-        m_topico_temp = base + "i_temperatura";
-        m_topico_elet = base + "i_falha_eletrica";
-        m_topico_hidr = base + "i_falha_hidraulica";
+        // mesma amostra bruta que o Tratamento de Sensores e o Agregador leem
+        m_topico_raw = "atr/" + std::to_string(m_id) + "/sensor/raw";
 
-        // Conexão MQTT usando paho.mqtt.cpp
-        mqtt::connect_options opts;
-        opts.set_clean_session(true);
+        // Rota pré-vinculada: o tópico é resolvido uma vez na trie
+        m_rotas.registrar(m_topico_raw, [this](const MensagemMQTT& m, int) { processar_amostra(m.payload); });
 
-        try {
-            auto tok = m_client.connect(opts);
-            tok->wait();
-            std::cout << "[Monitor " << m_id << "] Conectado em " << m_server_uri << '\n';
+        // modo consumer antes de assinar: permite usar consumir_por() e
+        // nenhuma mensagem chega sem fila
+        m_client->iniciar_consumo();
 
-            // modo consumer: permite usar consume_message_for()
-            m_client.start_consuming();
-
-            // Assina os três tópicos de sensores
-            m_client.subscribe(m_topico_temp, 1)->wait();
-            m_client.subscribe(m_topico_elet, 1)->wait();
-            m_client.subscribe(m_topico_hidr, 1)->wait();
-
-            m_last_msg = Clock::now();
-        }
-        catch (const std::exception& e) {
-            std::cerr << "[Monitor " << m_id << "] ERRO conexao MQTT: " << e.what() << '\n';
-            throw;
-        }
+        // Conecta e assina; se o broker ainda não subiu ou cair depois,
+        // a sessão é refeita com backoff.
+        m_client->conectar_sessao({assinatura(m_topico_raw)}, "Monitor " + std::to_string(m_id));
+        std::cout << "[Monitor " << m_id << "] Conectado em " << m_server_uri << '\n';
     }
 
     ~MonitorMQTT() {
         try {
-            m_client.stop_consuming();
-            if (m_client.is_connected()) {
-                m_client.unsubscribe(m_topico_temp)->wait();
-                m_client.unsubscribe(m_topico_elet)->wait();
-                m_client.unsubscribe(m_topico_hidr)->wait();
-                m_client.disconnect()->wait();
+            m_client->parar_consumo();
+            if (m_client->conectado()) {
+                m_client->cancelar_assinatura(m_topico_raw);
+                m_client->desconectar();
             }
         } catch (...) {
             // evitar exceção em destrutor
@@ -102,19 +106,15 @@ public:
     // - verifica watchdog de timeout
     void step() {
         // tenta ler uma msg com timeout curto
-        mqtt::const_message_ptr msg;
-        if (m_client.try_consume_message_for(&msg, 100ms) && msg) {
+        MensagemPtr msg;
+        if (m_client->consumir_por(msg, 100ms) && msg) {
             m_last_msg = Clock::now();
-
-            const std::string topic   = msg->get_topic();
-            const std::string payload = msg->to_string();
-
-            if (topic == m_topico_temp) {
-                processar_temperatura(payload);
-            } else if (topic == m_topico_elet) {
-                processar_eletrica(payload);
-            } else if (topic == m_topico_hidr) {
-                processar_hidraulica(payload);
+            m_carimbo = Carimbo{++m_seq_ingresso, em_ns(msg->recebida)};
+            m_rotas.despachar(*msg);
+            m_carimbo = {}; // eventos do watchdog não vêm de uma leitura
+            if (!m_primeira_msg) {
+                m_primeira_msg = true;
+                registrar_marco("Monitor " + std::to_string(m_id) + ": primeira leitura de sensor");
             }
         }
 
@@ -126,99 +126,149 @@ private:
     NotificadorEventos& m_notif;
     FaultConfig m_cfg;
 
+    // Tendência da temperatura (um caminhão por monitor: um índice só)
+    PrevisaoTermica m_previsao;
+    std::size_t m_slot_previsao = m_previsao.adicionar();
+
     // MQTT
     std::string m_server_uri;
-    mqtt::async_client m_client;
+    std::unique_ptr<ClienteMQTT> m_client;
 
-    // Tópicos
-    std::string m_topico_temp;
-    std::string m_topico_elet;
-    std::string m_topico_hidr;
+    // Tópico
+    std::string m_topico_raw;
+    RoteadorTopicos m_rotas;
+
+    // Falhas que colocam o caminhão em defeito, um bit por origem
+    enum Defeito : std::uint8_t {
+        DEF_TERMICO    = 1u << 0,
+        DEF_ELETRICO   = 1u << 1,
+        DEF_HIDRAULICO = 1u << 2,
+        DEF_SENSOR     = 1u << 3
+    };
 
     // Estado interno (mesma lógica anterior)
     TimePoint m_last_msg{};
     bool m_alerta_termico   = false;
-    bool m_falha_termica    = false;
-    bool m_falha_eletrica   = false;
-    bool m_falha_hidraulica = false;
-    bool m_falha_sensor     = false;
+    std::uint8_t m_defeitos = 0; // Defeito ativos
+    bool m_primeira_msg     = false;
+
+    // carimbo da leitura em processamento (vazio fora do despacho)
+    std::uint64_t m_seq_ingresso = 0;
+    Carimbo m_carimbo;
+
+    void disparar(TipoEvento tipo, double tempo_ate_falha_s = 0.0) {
+        m_notif.disparar_evento(tipo, m_carimbo, m_id, tempo_ate_falha_s);
+        ExportadorTrace::intervalo("monitor: mqtt->evento", m_id, m_carimbo.t_ingresso_ns,
+                                   agora_ns(), m_carimbo.seq);
+    }
+
+    bool ativo(Defeito d) const { return (m_defeitos & d) != 0; }
+
+    void ativar(Defeito d, TipoEvento tipo) {
+        m_defeitos = static_cast<std::uint8_t>(m_defeitos | d);
+        disparar(tipo);
+    }
+
+    // a Lógica de Comando aceita o rearme após a NORMALIZACAO: só avisa
+    // quando a última falha ativa some
+    void normalizar(Defeito d) {
+        m_defeitos = static_cast<std::uint8_t>(m_defeitos & ~d);
+        if (m_defeitos == 0) disparar(TipoEvento::NORMALIZACAO);
+    }
 
     static std::string build_server_uri() {
         // BROKER_ADDRESS e BROKER_PORT devem vir de config.h
-        return "tcp://" + std::string(BROKER_ADDRESS) + ":" + std::to_string(BROKER_PORT);
+        return uri_broker(BROKER_ADDRESS, BROKER_PORT);
     }
 
-    void processar_temperatura(const std::string& payload) {
-        try {
-            const int temp = std::stoi(payload);
-
-            // Falha térmica (histerese)
-            if (!m_falha_termica && temp > m_cfg.falha_on) {
-                m_falha_termica = true;
-                std::cout << "[Monitor " << m_id << "] DEFEITO: Temp " << temp << "°C\n";
-                m_notif.disparar_evento(TipoEvento::DEFEITO_TERMICO);
-            } else if (m_falha_termica && temp < m_cfg.falha_off) {
-                m_falha_termica = false;
-                m_notif.disparar_evento(TipoEvento::NORMALIZACAO);
-            }
+    // campo ausente na amostra: o estado daquela falha não muda
+    void processar_amostra(const std::string& payload) {
+        double temp;
+        if (json_numero(payload, "i_temperatura", temp)) processar_temperatura(temp);
+        bool falha;
+        if (json_booleano(payload, "i_falha_eletrica", falha)) processar_eletrica(falha);
+        if (json_booleano(payload, "i_falha_hidraulica", falha)) processar_hidraulica(falha);
+    }
 
-            // Alerta térmico (histerese), só se não estiver em falha
-            if (!m_falha_termica) {
-                if (!m_alerta_termico && temp > m_cfg.alerta_on) {
-                    m_alerta_termico = true;
-                    std::cout << "[Monitor " << m_id << "] ALERTA: Temp " << temp << "°C\n";
-                    m_notif.disparar_evento(TipoEvento::ALERTA_TERMICO);
-                } else if (m_alerta_termico && temp < m_cfg.alerta_off) {
-                    m_alerta_termico = false;
-                    m_notif.disparar_evento(TipoEvento::NORMALIZACAO);
-                }
+    void processar_temperatura(double lido) {
+        // "nan"/"inf" cortariam os limiares e a previsão
+        if (!std::isfinite(lido)) return;
+        const double temp = std::trunc(lido); // limiares em °C inteiros
+        prever_temperatura(lido);
+
+        // Falha térmica (histerese)
+        if (!ativo(DEF_TERMICO) && temp > m_cfg.falha_on) {
+            std::cout << "[Monitor " << m_id << "] DEFEITO: Temp " << temp << "°C\n";
+            ativar(DEF_TERMICO, TipoEvento::DEFEITO_TERMICO);
+        } else if (ativo(DEF_TERMICO) && temp < m_cfg.falha_off) {
+            normalizar(DEF_TERMICO);
+        }
+
+        // Alerta térmico (histerese), só se não estiver em falha
+        if (!ativo(DEF_TERMICO)) {
+            if (!m_alerta_termico && temp > m_cfg.alerta_on) {
+                m_alerta_termico = true;
+                std::cout << "[Monitor " << m_id << "] ALERTA: Temp " << temp << "°C\n";
+                disparar(TipoEvento::ALERTA_TERMICO);
+            } else if (m_alerta_termico && temp < m_cfg.alerta_off) {
+                m_alerta_termico = false;
+                // alerta não é defeito: com outra falha ativa, não há o que normalizar
+                if (m_defeitos == 0) disparar(TipoEvento::NORMALIZACAO);
             }
-        } catch (...) {
-            // ignora payload inválido
         }
     }
 
-    void processar_eletrica(const std::string& payload) {
-        const bool atual = (payload == "1" || payload == "true");
-        if (atual != m_falha_eletrica) {
-            m_falha_eletrica = atual;
-            if (m_falha_eletrica) {
+    void prever_temperatura(double temp) {
+        const std::int64_t t_ns = m_carimbo.valido() ? m_carimbo.t_ingresso_ns : agora_ns();
+        const double tempo = m_previsao.atualizar(m_slot_previsao, temp, static_cast<double>(t_ns) * 1e-9);
+
+        // já em defeito térmico: a previsão não acrescenta nada
+        if (ativo(DEF_TERMICO) || !m_previsao.novo_alerta(m_slot_previsao, tempo)) return;
+
+        std::cout << "[Monitor " << m_id << "] PREVISÃO: falha térmica em ~" << std::lround(tempo)
+                  << " s (T=" << m_previsao.nivel(m_slot_previsao) << "°C, "
+                  << m_previsao.tendencia(m_slot_previsao) * 60.0 << " °C/min)\n";
+        disparar(TipoEvento::ALERTA_PREDITIVO, tempo);
+    }
+
+    void processar_eletrica(bool atual) {
+        if (atual != ativo(DEF_ELETRICO)) {
+            if (atual) {
                 std::cout << "[Monitor " << m_id << "] DEFEITO: Falha Elétrica!\n";
-                m_notif.disparar_evento(TipoEvento::FALHA_ELETRICA);
+                ativar(DEF_ELETRICO, TipoEvento::FALHA_ELETRICA);
             } else {
-                m_notif.disparar_evento(TipoEvento::NORMALIZACAO);
+                normalizar(DEF_ELETRICO);
             }
         }
     }
 
-    void processar_hidraulica(const std::string& payload) {
-        const bool atual = (payload == "1" || payload == "true");
-        if (atual != m_falha_hidraulica) {
-            m_falha_hidraulica = atual;
-            if (m_falha_hidraulica) {
+    void processar_hidraulica(bool atual) {
+        if (atual != ativo(DEF_HIDRAULICO)) {
+            if (atual) {
                 std::cout << "[Monitor " << m_id << "] DEFEITO: Falha Hidráulica!\n";
-                m_notif.disparar_evento(TipoEvento::FALHA_HIDRAULICA);
+                ativar(DEF_HIDRAULICO, TipoEvento::FALHA_HIDRAULICA);
             } else {
-                m_notif.disparar_evento(TipoEvento::NORMALIZACAO);
+                normalizar(DEF_HIDRAULICO);
             }
         }
     }
 
     void verificar_watchdog() {
+        // sem fonte periódica configurada, ou antes da primeira amostra: desarmado
+        if (m_cfg.timeout.count() <= 0 || !m_primeira_msg) return;
+
         const auto now = Clock::now();
         const auto dt  = now - m_last_msg;
 
         if (dt > m_cfg.timeout) {
-            if (!m_falha_sensor) {
+            if (!ativo(DEF_SENSOR)) {
                 std::cerr << "[Monitor " << m_id << "] TIMEOUT DOS SENSORES!\n";
-                m_falha_sensor = true;
-                m_notif.disparar_evento(TipoEvento::FALHA_SENSOR_TIMEOUT);
+                ativar(DEF_SENSOR, TipoEvento::FALHA_SENSOR_TIMEOUT);
             }
         } else {
-            if (m_falha_sensor) {
+            if (ativo(DEF_SENSOR)) {
                 std::cout << "[Monitor " << m_id << "] Sensores recuperados.\n";
-                m_falha_sensor = false;
-                m_notif.disparar_evento(TipoEvento::NORMALIZACAO);
+                normalizar(DEF_SENSOR);
             }
         }
     }
@@ -233,7 +283,10 @@ void tarefa_monitoramento_falhas(int id, NotificadorEventos& notificador) {
     std::cout << "[Monitor " << id << "] Iniciado.\n";
 
     FaultConfig cfg;
-    // se a conexão falhar, o construtor já mostra o erro
+    if (const char* ms = std::getenv("ATR_MONITOR_TIMEOUT_MS")) {
+        cfg.timeout = std::chrono::milliseconds(std::atoi(ms));
+    }
+    // o construtor só retorna com a sessão MQTT pronta (tenta de novo até conseguir)
     MonitorMQTT monitor(id, notificador, cfg);
 
     while (true) {
@@ -1,4 +1,8 @@
-#include <mqtt/async_client.h>
+#include "Buffer_Circular.h"
+#include "Cliente_MQTT.h"
+#include "Politicas_Entrega.h"
+#include "Rastreamento.h"
+
 #include <nlohmann/json.hpp>
 
 #include <iostream>
@@ -31,57 +35,41 @@ void tarefa_planejamento_rota(int id, BufferCircular& buffer)
 {
     std::cout << "[Planejamento " << id << "] Thread iniciada.\n";
 
-    const std::string broker    = "tcp://localhost:1883";
+    const std::string broker    = uri_broker("localhost");
     const std::string client_id = "planner_" + std::to_string(id);
     const std::string topic_sp  = "atr/" + std::to_string(id) + "/gestao/setpoint_posicao_final";
     const std::string topic_log = "atr/" + std::to_string(id) + "/planner/log";
+    const int qos_log           = qos_do_topico(topic_log); // logs: QoS 0 por padrão
 
-    mqtt::async_client cli(broker, client_id);
-    mqtt::connect_options connOpts;
-    connOpts.set_clean_session(true);
+    auto cli = criar_cliente_mqtt(broker, client_id);
 
     DestinoCompartilhado destino;
 
-    try {
-        cli.connect(connOpts)->wait();
-        cli.subscribe(topic_sp, 1)->wait();
-        std::cout << "[Planejamento " << id << "] Conectado ao broker.\n";
-    } catch (const std::exception& e) {
-        std::cerr << "[Planejamento " << id << "] ERRO MQTT: " << e.what() << "\n";
-        return;
-    }
-
-    class Cb : public virtual mqtt::callback {
-        DestinoCompartilhado& dest_;
-        std::string topic_log_;
-        mqtt::async_client& cli_;
-    public:
-        Cb(DestinoCompartilhado& d, std::string log, mqtt::async_client& c)
-            : dest_(d), topic_log_(std::move(log)), cli_(c) {}
-
-        void message_arrived(mqtt::const_message_ptr msg) override {
-            try {
-                auto j = json::parse(msg->to_string());
-                if (!j.contains("x") || !j.contains("y"))
-                    return;
-
-                {
-                    std::lock_guard<std::mutex> lk(dest_.mtx);
-                    dest_.x = j["x"].get<double>();
-                    dest_.y = j["y"].get<double>();
-                    dest_.ativo = true;
-                }
+    // Callback de setpoint: roda na thread do transporte MQTT
+    cli->definir_callback([&destino, &cli, topic_log, qos_log](const MensagemPtr& msg) {
+        try {
+            auto j = json::parse(msg->payload);
+            if (!j.contains("x") || !j.contains("y"))
+                return;
 
-                cli_.publish(topic_log_, "Novo destino recebido", 1, false);
-                dest_.cv.notify_all();
-            } catch (const std::exception& e) {
-                std::cerr << "[Planejamento] erro parse setpoint: " << e.what() << "\n";
+            {
+                std::lock_guard<std::mutex> lk(destino.mtx);
+                destino.x = j["x"].get<double>();
+                destino.y = j["y"].get<double>();
+                destino.ativo = true;
             }
+
+            cli->publicar(topic_log, "Novo destino recebido", qos_log, false);
+            destino.cv.notify_all();
+        } catch (const std::exception& e) {
+            std::cerr << "[Planejamento] erro parse setpoint: " << e.what() << "\n";
         }
-    };
+    });
 
-    auto cb = std::make_shared<Cb>(destino, topic_log, cli);
-    cli.set_callback(*cb);
+    // não desiste se o broker ainda não subiu: tenta de novo com backoff,
+    // e refaz a sessão sozinho se a conexão cair depois
+    cli->conectar_sessao({assinatura(topic_sp)}, "Planejamento " + std::to_string(id));
+    std::cout << "[Planejamento " << id << "] Conectado ao broker.\n";
 
     const double V_MAX    = 2.0;
     const double KP_DIST  = 0.8;
@@ -89,6 +77,8 @@ void tarefa_planejamento_rota(int id, BufferCircular& buffer)
     const double DIST_TOL = 0.25;
     const double ANG_TOL  = 2.0;
 
+    std::uint64_t seq_rastreada = 0; // cada posição entra no trace uma vez só
+
     while (true) {
         // Espera até alguém definir um destino ativo
         {
@@ -129,9 +119,15 @@ void tarefa_planejamento_rota(int id, BufferCircular& buffer)
             BufferCircular::SetpointsNavegacao sp{};
             sp.set_velocidade = sp_vel;
             sp.set_pos_angular = sp_ang;
+            sp.origem          = pos.carimbo;
+            sp.t_calculado_ns  = agora_ns();
             buffer.set_setpoints_navegacao(sp);
 
-
+            if (pos.carimbo.seq != seq_rastreada) {
+                seq_rastreada = pos.carimbo.seq;
+                ExportadorTrace::intervalo("planejamento: mqtt->setpoint", id, pos.carimbo.t_ingresso_ns,
+                                           sp.t_calculado_ns, pos.carimbo.seq);
+            }
 
             // Condição de chegada
             if (dist < DIST_TOL && std::fabs(err_ang) < ANG_TOL) {
@@ -139,7 +135,12 @@ void tarefa_planejamento_rota(int id, BufferCircular& buffer)
                     std::lock_guard<std::mutex> lk(destino.mtx);
                     destino.ativo = false;
                 }
-                cli.publish(topic_log, "Destino atingido", 1, false);
+                try {
+                    cli->publicar(topic_log, "Destino atingido", qos_log, false);
+                } catch (const std::exception& e) {
+                    // reconectando e sem espaço no buffer offline: o log se perde, o controle segue
+                    std::cerr << "[Planejamento " << id << "] log não publicado: " << e.what() << "\n";
+                }
                 break;
             }
 
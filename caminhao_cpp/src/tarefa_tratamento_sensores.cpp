@@ -1,112 +1,203 @@
-
-
-#include <mqtt/async_client.h>
-#include <nlohmann/json.hpp>
-#include <deque>
+#include "Buffer_Circular.h"
+#include "Cliente_MQTT.h"
+#include "Contador_Alocacoes.h"
+#include "Historico_Trajetoria.h"
+#include "Json_Plano.h"
+#include "Marcos_Inicializacao.h"
+#include "Politicas_Entrega.h"
+#include "Rastreamento.h"
+#include "Roteador_Topicos.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <mutex>
 #include <atomic>
 #include <iostream>
-<<<<<<< HEAD
 #include <string>
-
-const std::string BROKER_ADRESS = "tcp://localhost:1883";
-const int BROKER_PORT = 1883;
-=======
-#include <cctype>
->>>>>>> parent of 7f4b17e (Mudanças em tarefa_monitoramento_sensores.cpp e ajustes em tarefa_monitoramento_falhas.cpp para conseguir dar build)
-
-using json = nlohmann::json;
+#include <vector>
 
 namespace atr {
 
-// ====== estado vinculado pelo bind ======
-static BufferCircular* g_buf = nullptr;
-static int g_local_id = 1;
-static std::atomic<bool> g_stop{false};
-
-void tratamento_sensores(BufferCircular* buffer_ptr, int caminhao_id) {
-    g_buf = buffer_ptr;
-    g_local_id = caminhao_id;
-    std::cout << "[Tratamento] bind: id=" << g_local_id << " buffer=" << (void*)g_buf << "\n";
-}
-
-// ====== filtro de média móvel ======
+// ====== filtro de média móvel (janela fixa em anel: não aloca) ======
 struct MovingAvg {
-    std::deque<double> w; size_t M=5; double sum=0;
-    double push(double v){ w.push_back(v); sum+=v; if(w.size()>M){ sum-=w.front(); w.pop_front(); } return sum/w.size(); }
+    static constexpr size_t M = 5;
+    std::array<double, M> w{}; size_t n=0, pos=0; double sum=0;
+    double push(double v){ if(n==M) sum-=w[pos]; else ++n; w[pos]=v; sum+=v; pos=(pos+1)%M; return sum/n; }
 };
 
-static MovingAvg g_fx{};
-static MovingAvg g_fy{};
-static MovingAvg g_fang{};
+// ====== estado vinculado pelo bind (um registro por caminhão) ======
+struct CaminhaoVinculado {
+    int id;
+    BufferCircular* buf;
+    HistoricoTrajetoria* historico; // opcional
+    MovingAvg fx, fy, fang;
+    std::uint64_t seq = 0; // sequência de ingresso das amostras deste caminhão
+};
+
+static std::vector<CaminhaoVinculado> g_caminhoes;
+static RoteadorTopicos g_rotas; // "atr/<id>/sensor/raw" -> índice em g_caminhoes
+static std::atomic<bool> g_stop{false};
 static std::mutex g_mtx;
+static bool g_primeira_amostra = false; // marco de inicialização já registrado
+
+// ====== idade das amostras ao serem consumidas (janela de relatório) ======
+struct IdadeAmostras {
+    std::uint64_t n = 0, n_origem = 0;
+    double soma_fila = 0, max_fila = 0;     // ms: chegada ao cliente -> consumo
+    double soma_origem = 0, max_origem = 0; // ms: "ts" do sensor -> consumo
+
+    void medir(const MensagemMQTT& msg, std::chrono::steady_clock::time_point agora) {
+        const double fila = std::chrono::duration<double, std::milli>(agora - msg.recebida).count();
+        soma_fila += fila;
+        max_fila = std::max(max_fila, fila);
+        ++n;
+
+        double ts = 0.0; // relógio de parede do simulador (s desde a época)
+        if (json_numero(msg.payload, "ts", ts)) {
+            const double agora_s = std::chrono::duration<double>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            const double origem = (agora_s - ts) * 1000.0;
+            soma_origem += origem;
+            max_origem = std::max(max_origem, origem);
+            ++n_origem;
+        }
+    }
 
-// extrai número do truck_id (aceita "1" ou "T001")
-static int parse_truck_num(const std::string& tid){
-    try { return std::stoi(tid); }
-    catch(...) {
-        std::string d; for(char c: tid) if (std::isdigit((unsigned char)c)) d.push_back(c);
-        return d.empty()? 0 : std::stoi(d);
+    void relatar(std::uint64_t substituidas) const {
+        if (n == 0) return;
+        std::cout << "[Tratamento] idade das amostras: fila média " << soma_fila / n
+                  << " ms (máx " << max_fila << ")";
+        if (n_origem > 0) {
+            std::cout << ", desde o sensor média " << soma_origem / n_origem
+                      << " ms (máx " << max_origem << ")";
+        }
+        std::cout << "; " << n << " consumidas, " << substituidas << " substituídas por mais novas\n";
     }
-}
+};
 
-static void handle_raw_sample(const json& j){
-    if(!g_buf) return;
+static std::string topico_sensor(int caminhao_id) {
+    return "atr/" + std::to_string(caminhao_id) + "/sensor/raw";
+}
 
-    int num = parse_truck_num(j.value("truck_id", "0"));
-    if (num != g_local_id) return; // só o meu caminhão
+static void handle_raw_sample(int indice, const MensagemMQTT& msg){
+    CaminhaoVinculado& cam = g_caminhoes[indice];
+    const std::string& payload = msg.payload;
 
-    // campos definidos no simulador (Tabela 1)
-    double x   = j.value("i_posicao_x", 0.0);
-    double y   = j.value("i_posicao_y", 0.0);
-    double ang = j.value("i_angulo_x",  0.0);
+    // campos definidos no simulador (Tabela 1), lidos direto do payload (sem DOM)
+    double x = 0.0, y = 0.0, ang = 0.0;
+    if (!json_numero(payload, "i_posicao_x", x) || !json_numero(payload, "i_posicao_y", y)) {
+        std::cerr << "[Tratamento] amostra inválida: " << payload << "\n";
+        return;
+    }
+    json_numero(payload, "i_angulo_x", ang);
 
     double fx, fy, fang;
+    std::uint64_t seq;
     {
         std::lock_guard<std::mutex> lk(g_mtx);
-        fx   = g_fx.push(x);
-        fy   = g_fy.push(y);
-        fang = g_fang.push(ang);
+        fx   = cam.fx.push(x);
+        fy   = cam.fy.push(y);
+        fang = cam.fang.push(ang);
+        seq  = ++cam.seq;
     }
 
+    // carimbo de ingresso: acompanha a posição até setpoints e atuadores
     BufferCircular::PosicaoData pos{};
     pos.i_pos_x    = fx;
     pos.i_pos_y    = fy;
     pos.i_angulo_x = fang;
-    g_buf->set_posicao_tratada(pos);
+    pos.carimbo    = Carimbo{seq, em_ns(msg.recebida)};
+    cam.buf->set_posicao_tratada(pos);
+    const auto escrita = std::chrono::steady_clock::now();
+    if (cam.historico) {
+        cam.historico->registrar(pos, escrita);
+    }
+    ExportadorTrace::intervalo("sensor: mqtt->buffer", cam.id, pos.carimbo.t_ingresso_ns,
+                               em_ns(escrita), seq);
+
+    if (!g_primeira_amostra) {
+        g_primeira_amostra = true;
+        registrar_marco("Tratamento: primeira amostra processada (caminhão " + std::to_string(cam.id) + ")");
+    }
+}
+
+void tratamento_sensores(BufferCircular* buffer_ptr, int caminhao_id, HistoricoTrajetoria* historico) {
+    // o caminhão é identificado pelo tópico (resolvido na trie), e não
+    // mais pelo "truck_id" do JSON: amostras de outros caminhões nem são parseadas
+    const int indice = static_cast<int>(g_caminhoes.size());
+    g_caminhoes.push_back(CaminhaoVinculado{caminhao_id, buffer_ptr, historico, {}, {}, {}});
+    g_rotas.registrar(topico_sensor(caminhao_id),
+        [](const MensagemMQTT& msg, int idx) { handle_raw_sample(idx, msg); },
+        indice);
+    std::cout << "[Tratamento] bind: id=" << caminhao_id << " buffer=" << (void*)buffer_ptr << "\n";
 }
 
 void tarefa_tratamento_sensores_run(const std::string& broker) {
-    if (!g_buf) {
+    if (g_caminhoes.empty()) {
         std::cerr << "[Tratamento] ERRO: chame tratamento_sensores(&buffer, id) antes da thread!\n";
         return;
     }
-    const std::string uri = "tcp://" + broker + ":1883";
-    mqtt::async_client cli(uri, "cpp_filter_" + std::to_string(::time(nullptr)));
-    mqtt::connect_options conn; conn.set_clean_session(true);
+    const std::string uri = uri_broker(broker);
+    auto cli = criar_cliente_mqtt(uri, "cpp_filter_" + std::to_string(::time(nullptr)));
 
     try {
-        cli.connect(conn)->wait();
-        cli.start_consuming();
-        cli.subscribe("atr/+/sensor/raw", 1)->wait();
-        std::cout << "[Tratamento] conectado ao broker " << uri << " (local_id=" << g_local_id << ")\n";
+        cli->iniciar_consumo();
+        // todos os caminhões em um único SUBSCRIBE (e de novo a cada reconexão)
+        std::vector<Assinatura> lote;
+        lote.reserve(g_caminhoes.size());
+        for (const auto& cam : g_caminhoes) {
+            // telemetria: ULTIMO_VALOR por padrão (QoS 0, só a amostra mais nova na fila)
+            lote.push_back(assinatura(topico_sensor(cam.id)));
+        }
+        cli->conectar_sessao(lote, "Tratamento");
+        std::cout << "[Tratamento] conectado ao broker " << uri << " (caminhoes=" << g_caminhoes.size() << ")\n";
+
+        // com ATR_CONTAR_ALOCACOES: alocações desta thread por mensagem, a cada janela
+        const std::uint64_t JANELA_ALOC = 1000;
+        std::uint64_t msgs_janela = 0;
+        ContagemAlocacoes aloc_inicio = alocacoes_da_thread();
+
+        // idade das amostras consumidas, relatada a cada JANELA_IDADE
+        const auto JANELA_IDADE = std::chrono::seconds(5);
+        IdadeAmostras idade;
+        std::uint64_t substituidas_antes = 0;
+        auto t_relatorio = std::chrono::steady_clock::now();
 
         while (!g_stop.load()) {
-            // Versão compatível: bloqueia até chegar mensagem (ou desconectar)
-            auto msg = cli.consume_message();
+            // bloqueia até chegar mensagem (ou parar o consumo)
+            auto msg = cli->consumir();
             if (!msg) continue;
 
-            try {
-                auto j = json::parse(msg->get_payload());
-                handle_raw_sample(j);
-            } catch (const std::exception& e) {
-                std::cerr << "[Tratamento] parse erro: " << e.what() << "\n";
+            const auto agora = std::chrono::steady_clock::now();
+            idade.medir(*msg, agora);
+            if (agora - t_relatorio >= JANELA_IDADE) {
+                const std::uint64_t substituidas = cli->substituidas();
+                idade.relatar(substituidas - substituidas_antes);
+                substituidas_antes = substituidas;
+                idade = IdadeAmostras{};
+                t_relatorio = agora;
+            }
+
+            g_rotas.despachar(*msg);
+            msg.reset(); // devolve ao pool dentro da janela medida
+
+            if (contador_alocacoes_ativo() && ++msgs_janela == JANELA_ALOC) {
+                const ContagemAlocacoes agora = alocacoes_da_thread();
+                std::cout << "[Tratamento] alocacoes/mensagem: "
+                          << double(agora.alocacoes - aloc_inicio.alocacoes) / JANELA_ALOC
+                          << " (bytes/mensagem: "
+                          << double(agora.bytes - aloc_inicio.bytes) / JANELA_ALOC << ")\n";
+                msgs_janela = 0;
+                aloc_inicio = alocacoes_da_thread(); // após o cout
             }
         }
 
-        cli.unsubscribe("atr/+/sensor/raw")->wait();
-        cli.stop_consuming();
-        cli.disconnect()->wait();
+        for (const auto& cam : g_caminhoes) {
+            cli->cancelar_assinatura(topico_sensor(cam.id));
+        }
+        cli->parar_consumo();
+        cli->desconectar();
     } catch (const std::exception& e) {
         std::cerr << "[Tratamento] MQTT erro: " << e.what() << "\n";
     }
@@ -1,6 +1,9 @@
 #!/usr/bin/env bash
 set -e
 
+# Instante de subida do container: origem dos marcos de inicialização do núcleo C++
+export ATR_T0_CONTAINER="${ATR_T0_CONTAINER:-$(date +%s.%N)}"
+
 # Variáveis com defaults
 START_UI="${START_UI:-0}"
 START_SIMULATOR="${START_SIMULATOR:-1}"
@@ -8,9 +11,8 @@ BROKER_HOST="${BROKER_HOST:-localhost}"
 
 echo "[start] Iniciando broker Mosquitto..."
 mosquitto -d
-sleep 0.8
 
-# Checa binário C++
+# Checa binário C++ (não espera o broker: as tarefas reconectam com backoff)
 BIN_CPP="/app/caminhao_cpp/build/caminhao_embarcado"
 if [ -x "$BIN_CPP" ]; then
   echo "[start] Iniciando núcleo C++: $BIN_CPP"
@@ -19,6 +21,9 @@ else
   echo "[start][AVISO] Binário C++ não encontrado em $BIN_CPP"
 fi
 
+# o cliente Python não tenta de novo: dá tempo ao broker
+sleep 0.8
+
 # (opcional) Inicia simulador Python para gerar sensores brutos via MQTT
 if [ "$START_SIMULATOR" = "1" ]; then
   if [ -f "/app/interface_unificada/simulator_view.py" ]; then